@@ -8,19 +8,25 @@
 
 using namespace MEngine;
 
+constexpr ComponentMask BUTTON_SYSTEM_MASK = POS_SIZE_COMPONENT_MASK | BUTTON_COMPONENT_MASK;
+
+ButtonSystem::ButtonSystem() : System(SystemSettings::NONE, BUTTON_SYSTEM_MASK)
+{
+}
+
 void ButtonSystem::UpdatePresentationLayer(float deltaTime)
 {
 	int32_t cursorPosX = GetCursorPosX();
 	int32_t cursorPosY = GetCursorPosY();
 	
-	std::vector<EntityID> entities;
-	GetEntitiesMatchingMask(PosSizeComponent::GetComponentMask() | ButtonComponent::GetComponentMask(), entities);
+	ApplyComponentEvents(GetComponentEvents(), BUTTON_SYSTEM_MASK, m_Buttons);
+	const std::vector<EntityID>& entities = m_Buttons.GetEntities();
 	for (int i = 0; i < entities.size(); ++i)
 	{
 		bool wasClicked = false;
 
-		ButtonComponent* buttonComp = static_cast<ButtonComponent*>(GetComponent(entities[i], ButtonComponent::GetComponentMask()));
-		const PosSizeComponent* posSizeComp = static_cast<const PosSizeComponent*>(GetComponent(entities[i], PosSizeComponent::GetComponentMask()));
+		ButtonComponent* buttonComp = GetComponent<ButtonComponent>(entities[i]);
+		const PosSizeComponent* posSizeComp = GetComponent<PosSizeComponent>(entities[i]);
 
 		if (buttonComp->Callback != nullptr && buttonComp->IsActive)
 		{
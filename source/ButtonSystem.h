@@ -1,7 +1,15 @@
 #pragma once
 #include "Interface/MEngineSystem.h"
+#include "Interface/MEngineTypes.h"
+#include <vector>
 
 class ButtonSystem : public MEngine::System
 {
+public:
+	ButtonSystem();
+
+private:
 	void UpdatePresentationLayer(float deltaTime) override;
+
+	MEngine::TrackedEntities m_Buttons; // Kept up to date through component events
 };
\ No newline at end of file
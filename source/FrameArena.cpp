@@ -0,0 +1,54 @@
+#include "FrameArena.h"
+#include <string.h>
+
+using namespace MEngine;
+
+FrameArena::FrameArena(size_t blockSize) : m_BlockSize(blockSize)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	for (size_t i = 0; i < m_Blocks.size(); ++i)
+	{
+		delete[] m_Blocks[i].Memory;
+	}
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	while (m_CurrentBlock < m_Blocks.size())
+	{
+		const Block& block = m_Blocks[m_CurrentBlock];
+		const size_t alignedOffset = (reinterpret_cast<uintptr_t>(block.Memory) + m_Offset + alignment - 1) / alignment * alignment - reinterpret_cast<uintptr_t>(block.Memory);
+		if (alignedOffset + size <= block.Size)
+		{
+			m_Offset = alignedOffset + size;
+			return block.Memory + alignedOffset;
+		}
+
+		// Whatever is left of this block stays unused until the next reset
+		++m_CurrentBlock;
+		m_Offset = 0;
+	}
+
+	const size_t blockSize = size + alignment > m_BlockSize ? size + alignment : m_BlockSize;
+	m_Blocks.push_back({ new uint8_t[blockSize], blockSize });
+	m_CurrentBlock = static_cast<uint32_t>(m_Blocks.size() - 1);
+	m_Offset = 0;
+	return Allocate(size, alignment);
+}
+
+const char* FrameArena::CopyText(const char* text, size_t length)
+{
+	char* copy = static_cast<char*>(Allocate(length + 1, alignof(char)));
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+void FrameArena::Reset()
+{
+	m_CurrentBlock	= 0;
+	m_Offset		= 0;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace MEngine
+{
+	class FrameArena // Linear allocator for data that lives until the next reset; resetting is O(1) and keeps all memory for reuse so a warmed up arena never allocates
+	{
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+		FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+		FrameArena(const FrameArena& other) = delete;
+		~FrameArena();
+
+		FrameArena& operator=(const FrameArena& other) = delete;
+
+		void*		Allocate(size_t size, size_t alignment = alignof(max_align_t)); // The memory is left uninitialized and must only hold trivially destructible data
+		const char*	CopyText(const char* text, size_t length); // Copies length characters and null terminates the copy
+		void		Reset(); // Invalidates everything allocated since the last reset
+
+	private:
+		struct Block
+		{
+			uint8_t*	Memory;
+			size_t		Size;
+		};
+
+		std::vector<Block>	m_Blocks;
+		uint32_t			m_CurrentBlock	= 0;
+		size_t				m_Offset		= 0;
+		size_t				m_BlockSize;
+	};
+}
\ No newline at end of file
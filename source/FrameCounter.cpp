@@ -1,13 +1,15 @@
 #include "FrameCounter.h"
 #include <SDL_timer.h>
 
-constexpr int32_t	FRAMECOUNTER_SAMPLE_COUNT	= 100;
-constexpr int32_t	MILLISECONDS_PER_SECOND		= 1000;
+constexpr uint32_t	FRAMECOUNTER_SAMPLE_COUNT		= 256;
+constexpr uint64_t	NANOSECONDS_PER_SECOND			= 1000000000;
+constexpr double	NANOSECONDS_PER_MILLISECOND		= 1000000.0;
 
 using namespace MEngine;
 
-FrameCounter::FrameCounter()
+FrameCounter::FrameCounter() : m_FrameTimes(FRAMECOUNTER_SAMPLE_COUNT), m_CPUTimes(FRAMECOUNTER_SAMPLE_COUNT), m_PresentWaitTimes(FRAMECOUNTER_SAMPLE_COUNT)
 {
+	m_FrameBudget = 0;
 	Reset();
 }
 
@@ -15,10 +17,20 @@ void FrameCounter::Tick()
 {
 	uint64_t performanceCounter = SDL_GetPerformanceCounter();
 
-	m_AverageDeltaTime -= m_AverageDeltaTime / FRAMECOUNTER_SAMPLE_COUNT;
-	m_AverageDeltaTime += performanceCounter / FRAMECOUNTER_SAMPLE_COUNT;
+	if (m_FrameCount > 0) // The first tick has nothing to measure against
+	{
+		m_LastDeltaTime = TicksToNanoseconds(performanceCounter - m_LastTickTime);
+		uint64_t presentWaitTime = m_PresentWaitTime < m_LastDeltaTime ? m_PresentWaitTime : m_LastDeltaTime;
 
-	m_LastDeltaTime = static_cast<float>((performanceCounter - m_LastTickTime) / m_PerformaceFrequency);
+		m_FrameTimes.AddSample(static_cast<float>(m_LastDeltaTime / NANOSECONDS_PER_MILLISECOND));
+		m_CPUTimes.AddSample(static_cast<float>((m_LastDeltaTime - presentWaitTime) / NANOSECONDS_PER_MILLISECOND));
+		m_PresentWaitTimes.AddSample(static_cast<float>(presentWaitTime / NANOSECONDS_PER_MILLISECOND));
+
+		if (m_FrameBudget > 0 && m_LastDeltaTime > m_FrameBudget)
+			++m_OverBudgetFrameCount;
+	}
+
+	m_PresentWaitTime = 0;
 	m_LastTickTime = performanceCounter;
 	++m_FrameCount;
 }
@@ -26,33 +38,119 @@ void FrameCounter::Tick()
 void FrameCounter::Reset()
 {
 	m_FrameCount			= 0;
+	m_OverBudgetFrameCount	= 0;
 	m_LastTickTime			= 0;
-	m_LastDeltaTime			= 0.0f;
-	m_AverageDeltaTime		= 0.0f;
+	m_LastDeltaTime			= 0;
+	m_PresentWaitStartTime	= 0;
+	m_PresentWaitTime		= 0;
 	m_PerformaceFrequency	= SDL_GetPerformanceFrequency();
+
+	m_FrameTimes.Clear();
+	m_CPUTimes.Clear();
+	m_PresentWaitTimes.Clear();
+}
+
+void FrameCounter::BeginPresentWait()
+{
+	m_PresentWaitStartTime = SDL_GetPerformanceCounter();
+}
+
+void FrameCounter::EndPresentWait()
+{
+	m_PresentWaitTime += TicksToNanoseconds(SDL_GetPerformanceCounter() - m_PresentWaitStartTime);
+}
+
+void FrameCounter::SetFrameBudget(float budgetMilliseconds)
+{
+	m_FrameBudget = budgetMilliseconds > 0.0f ? static_cast<uint64_t>(budgetMilliseconds * NANOSECONDS_PER_MILLISECOND) : 0;
 }
 
 float FrameCounter::GetDeltaTime() const
+{
+	return static_cast<float>(static_cast<double>(m_LastDeltaTime) / NANOSECONDS_PER_SECOND);
+}
+
+float FrameCounter::GetTimeSinceTick() const
+{
+	if (m_FrameCount == 0)
+		return 0.0f;
+
+	return static_cast<float>(static_cast<double>(TicksToNanoseconds(SDL_GetPerformanceCounter() - m_LastTickTime)) / NANOSECONDS_PER_SECOND);
+}
+
+uint64_t FrameCounter::GetDeltaTimeNanoseconds() const
 {
 	return m_LastDeltaTime;
 }
 
 float FrameCounter::GetAverageDeltaTime() const
 {
-	return m_AverageDeltaTime;
+	return m_FrameTimes.GetAverage() / 1000.0f;
 }
 
 uint32_t FrameCounter::GetFPS() const
 {
-	return  MILLISECONDS_PER_SECOND / static_cast<uint32_t>(m_LastDeltaTime);
+	return m_LastDeltaTime > 0 ? static_cast<uint32_t>(NANOSECONDS_PER_SECOND / m_LastDeltaTime) : 0;
 }
 
 uint32_t FrameCounter::GetAverageFPS() const
 {
-	return MILLISECONDS_PER_SECOND / static_cast<uint32_t>(m_AverageDeltaTime);
+	float averageDeltaTime = GetAverageDeltaTime();
+	return averageDeltaTime > 0.0f ? static_cast<uint32_t>(1.0f / averageDeltaTime + 0.5f) : 0;
 }
 
 uint64_t FrameCounter::GetPerformanceFrequency() const
 {
 	return m_PerformaceFrequency;
+}
+
+float FrameCounter::GetFrameTimePercentile(float percentile) const
+{
+	return m_FrameTimes.GetPercentile(percentile);
+}
+
+float FrameCounter::GetMaxFrameTime() const
+{
+	return m_FrameTimes.GetMax();
+}
+
+float FrameCounter::GetLastCPUTime() const
+{
+	return m_CPUTimes.GetLast();
+}
+
+float FrameCounter::GetAverageCPUTime() const
+{
+	return m_CPUTimes.GetAverage();
+}
+
+float FrameCounter::GetLastPresentWaitTime() const
+{
+	return m_PresentWaitTimes.GetLast();
+}
+
+float FrameCounter::GetAveragePresentWaitTime() const
+{
+	return m_PresentWaitTimes.GetAverage();
+}
+
+float FrameCounter::GetFrameBudget() const
+{
+	return static_cast<float>(m_FrameBudget / NANOSECONDS_PER_MILLISECOND);
+}
+
+uint64_t FrameCounter::GetOverBudgetFrameCount() const
+{
+	return m_OverBudgetFrameCount;
+}
+
+uint64_t FrameCounter::GetFrameCount() const
+{
+	return m_FrameCount;
+}
+
+uint64_t FrameCounter::TicksToNanoseconds(uint64_t ticks) const
+{
+	// Split the conversion so that the multiplication can not overflow for long frames
+	return (ticks / m_PerformaceFrequency) * NANOSECONDS_PER_SECOND + ((ticks % m_PerformaceFrequency) * NANOSECONDS_PER_SECOND) / m_PerformaceFrequency;
 }
\ No newline at end of file
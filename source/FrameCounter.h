@@ -1,27 +1,54 @@
 #pragma once
+#include "SampleBuffer.h"
 #include <stdint.h>
 
 namespace MEngine
 {
-	class FrameCounter
+	class FrameCounter // Measures frame times with nanosecond precision and keeps statistics over the most recent frames
 	{
 	public:
 		FrameCounter();
 
-		void		Tick();
+		void		Tick(); // Marks the start of a new frame
 		void		Reset();
 
-		float		GetDeltaTime() const;
-		float		GetAverageDeltaTime() const;
+		void		BeginPresentWait(); // Time between BeginPresentWait and EndPresentWait is counted as present wait instead of CPU time for the current frame
+		void		EndPresentWait();
+
+		void		SetFrameBudget(float budgetMilliseconds); // Frames longer than the budget are counted as over budget; 0 disables the count
+
+		float		GetDeltaTime() const; // Seconds
+		float		GetTimeSinceTick() const; // Seconds
+		uint64_t	GetDeltaTimeNanoseconds() const;
+		float		GetAverageDeltaTime() const; // Seconds
 		uint32_t	GetFPS() const;
 		uint32_t	GetAverageFPS() const;
 		uint64_t	GetPerformanceFrequency() const;
 
+		float		GetFrameTimePercentile(float percentile) const; // Milliseconds
+		float		GetMaxFrameTime() const; // Milliseconds
+		float		GetLastCPUTime() const; // Milliseconds
+		float		GetAverageCPUTime() const; // Milliseconds
+		float		GetLastPresentWaitTime() const; // Milliseconds
+		float		GetAveragePresentWaitTime() const; // Milliseconds
+		float		GetFrameBudget() const; // Milliseconds
+		uint64_t	GetOverBudgetFrameCount() const;
+		uint64_t	GetFrameCount() const;
+
 	private:
-		uint64_t	m_FrameCount;
-		uint64_t	m_LastTickTime;
-		float		m_LastDeltaTime;
-		float		m_AverageDeltaTime;
-		uint64_t	m_PerformaceFrequency;
+		uint64_t	TicksToNanoseconds(uint64_t ticks) const;
+
+		uint64_t		m_FrameCount;
+		uint64_t		m_OverBudgetFrameCount;
+		uint64_t		m_LastTickTime;
+		uint64_t		m_LastDeltaTime; // Nanoseconds
+		uint64_t		m_PresentWaitStartTime;
+		uint64_t		m_PresentWaitTime; // Nanoseconds spent in present wait since the last tick
+		uint64_t		m_FrameBudget; // Nanoseconds
+		uint64_t		m_PerformaceFrequency;
+
+		SampleBuffer	m_FrameTimes; // Milliseconds
+		SampleBuffer	m_CPUTimes;
+		SampleBuffer	m_PresentWaitTimes;
 	};
 }
\ No newline at end of file
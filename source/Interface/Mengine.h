@@ -8,6 +8,7 @@ namespace MEngine
 	constexpr int32_t DEFAULT_WINDOW_POS_Y	= 0;
 	constexpr int32_t DEFAULT_WINDOW_WIDTH	= 1024;
 	constexpr int32_t DEFAULT_WINDOW_HEIGHT = 768;
+	constexpr uint32_t DEFAULT_MAX_IDLE_MILLISECONDS = 500;
 
 	bool Initialize(const char* applicationName = "MEngineApp", InitFlags initFlags = InitFlags::None);
 	bool CreateWindow_(const char* windowTitle = "", int32_t windowPosX = DEFAULT_WINDOW_POS_X, int32_t windowPosY = DEFAULT_WINDOW_POS_Y, int32_t windowWidth = DEFAULT_WINDOW_WIDTH, int32_t windowHeight = DEFAULT_WINDOW_HEIGHT); // Underscore postfix avoids conflict with Windows.h macro CreateWindow
@@ -18,4 +19,10 @@ namespace MEngine
 		 
 	void Update();
 	void Render();
+
+	// While idle mode is enabled, Update waits for input (at most maxIdleMilliseconds) and Render is skipped after frames where no input arrived and no components were changed.
+	// Systems that animate without changing components should use SystemSettings::CONTINUOUS_UPDATES, and component data written without NotifyComponentsChanged requires a call to RequestFrame.
+	void SetIdleModeEnabled(bool enabled, uint32_t maxIdleMilliseconds = DEFAULT_MAX_IDLE_MILLISECONDS);
+	bool IsIdleModeEnabled();
+	void RequestFrame(); // Keeps the next frame from idling; may be called from any thread
 };
\ No newline at end of file
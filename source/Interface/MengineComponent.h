@@ -1,5 +1,6 @@
 #pragma once
 #include "MEngineTypes.h"
+#include <MUtilityMath.h>
 
 // https://en.wikipedia.org/wiki/Curiously_recurring_template_pattern
 namespace MEngine
@@ -24,23 +25,34 @@ namespace MEngine
 		{
 			ByteSize = sizeof(Derived);
 			ComponentMask = MEngine::RegisterComponentType(templateInstance, ByteSize, maxCount, componentName);
+			if (ComponentMask != MENGINE_INVALID_COMPONENT_MASK)
+				BufferIndex = MUtilityMath::FastLog2(ComponentMask); // Computed once here so that typed lookups need no log2
 		}
 
 		static bool Unregister()
 		{
+			bool result = false;
 			if (ComponentMask != MENGINE_INVALID_COMPONENT_MASK)
-				return MEngine::UnregisterComponentType(ComponentMask);
+				result = MEngine::UnregisterComponentType(ComponentMask);
 
-			return false;
+			ComponentMask = MENGINE_INVALID_COMPONENT_MASK;
+			BufferIndex = MENGINE_INVALID_COMPONENT_BUFFER_INDEX;
+			return result;
 		}
 
 		static ComponentMask GetComponentMask() { return ComponentMask; }
+		static uint32_t GetBufferIndex() { return BufferIndex; }
 		static uint32_t GetByteSize() { return ByteSize; }
 
 	private:
 		static ComponentMask ComponentMask;
+		static uint32_t BufferIndex;
 		static uint32_t ByteSize;
 	};
-	template <class Derived> ComponentMask ComponentBase<Derived>::ComponentMask;
+	template <class Derived> ComponentMask ComponentBase<Derived>::ComponentMask = MENGINE_INVALID_COMPONENT_MASK;
+	template <class Derived> uint32_t ComponentBase<Derived>::BufferIndex = MENGINE_INVALID_COMPONENT_BUFFER_INDEX;
 	template <class Derived> uint32_t ComponentBase<Derived>::ByteSize;
+
+	template <class... ComponentTypes>
+	ComponentMask ComponentMaskOf() { return (ComponentTypes::GetComponentMask() | ...); }
 }
\ No newline at end of file
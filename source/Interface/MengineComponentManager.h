@@ -4,7 +4,7 @@
 #include "MEngineComponent.h"
 #include <stdint.h>
 
-namespace MEngine // TODODB: Make thread safe
+namespace MEngine // Component type registration is thread safe; see MEngineWorld.h for how component data may be accessed concurrently
 {
 	ComponentMask RegisterComponentType(const MEngine::Component& templateComponent, uint32_t templateComponentSize, uint32_t maxCount, const char* componentName);
 	bool UnregisterComponentType(ComponentMask componentType);
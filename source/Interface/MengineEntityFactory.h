@@ -3,9 +3,9 @@
 #include "MEngineTypes.h"
 #include "MEngineInternalComponents.h"
 
-#define BUTTON_ENTITY_MASK (PosSizeComponent::GetComponentMask() | TextureRenderingComponent::GetComponentMask() | ButtonComponent::GetComponentMask() | TextComponent::GetComponentMask())
-#define TEXT_BOX_ENTITY_MASK (PosSizeComponent::GetComponentMask() | RectangleRenderingComponent::GetComponentMask() | TextComponent::GetComponentMask())
-#define TEXT_BOX_EDITABLE_ENTITY_MASK (PosSizeComponent::GetComponentMask() | RectangleRenderingComponent::GetComponentMask() | ButtonComponent::GetComponentMask() | TextComponent::GetComponentMask())
+constexpr MEngine::ComponentMask BUTTON_ENTITY_MASK				= MEngine::POS_SIZE_COMPONENT_MASK | MEngine::TEXTURE_RENDERING_COMPONENT_MASK | MEngine::BUTTON_COMPONENT_MASK | MEngine::TEXT_COMPONENT_MASK;
+constexpr MEngine::ComponentMask TEXT_BOX_ENTITY_MASK				= MEngine::POS_SIZE_COMPONENT_MASK | MEngine::RECTANGLE_RENDERING_COMPONENT_MASK | MEngine::TEXT_COMPONENT_MASK;
+constexpr MEngine::ComponentMask TEXT_BOX_EDITABLE_ENTITY_MASK	= MEngine::POS_SIZE_COMPONENT_MASK | MEngine::RECTANGLE_RENDERING_COMPONENT_MASK | MEngine::BUTTON_COMPONENT_MASK | MEngine::TEXT_COMPONENT_MASK;
 
 constexpr uint32_t MENGINE_DEFAULT_UI_BUTTON_DEPTH	= 50;
 constexpr uint32_t MENGINE_DEFAULT_UI_TEXTBOX_DEPTH = 25;
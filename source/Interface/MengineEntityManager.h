@@ -24,7 +24,29 @@ namespace MEngine
 	void GetEntitiesMatchingMask(ComponentMask componentMask, std::vector<EntityID>& outEntities, MaskMatchMode matchMode = MaskMatchMode::Partial);
 
 	MEngine::Component* GetComponent(EntityID ID, ComponentMask componentMask);
+	MEngine::Component* GetComponentByBufferIndex(EntityID ID, uint32_t componentBufferIndex); // Used by the typed accessors below; prefer GetComponent<T>
 	ComponentMask GetComponentMask(EntityID ID);
 
 	bool IsEntityIDValid(EntityID ID);
+
+	void NotifyComponentsChanged(EntityID ID, ComponentMask componentTypes); // Lets systems observing the component types, and the renderer, know that the components' data was modified; changes to rendered components are not drawn until reported. Safe to call during concurrent access
+
+	template <class ComponentType>
+	ComponentType* GetComponent(EntityID ID) { return static_cast<ComponentType*>(GetComponentByBufferIndex(ID, ComponentType::GetBufferIndex())); }
+
+	template <class... ComponentTypes>
+	ComponentMask AddComponents(EntityID ID) { return AddComponentsToEntity(ID, ComponentMaskOf<ComponentTypes...>()); }
+
+	template <class... ComponentTypes>
+	ComponentMask RemoveComponents(EntityID ID) { return RemoveComponentsFromEntity(ID, ComponentMaskOf<ComponentTypes...>()); }
+
+	template <class... ComponentTypes>
+	void MarkComponentsChanged(EntityID ID) { NotifyComponentsChanged(ID, ComponentMaskOf<ComponentTypes...>()); }
+
+	template <class... ComponentTypes>
+	bool HasComponents(EntityID ID)
+	{
+		const ComponentMask mask = ComponentMaskOf<ComponentTypes...>();
+		return (GetComponentMask(ID) & mask) == mask;
+	}
 }
\ No newline at end of file
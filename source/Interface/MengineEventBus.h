@@ -0,0 +1,57 @@
+#pragma once
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+
+namespace MEngine // Typed events published by systems and read in bulk by other systems; events published during a frame are delivered during the next frame
+{
+	uint32_t RegisterEventType(uint32_t eventSize, uint32_t eventAlignment); // Used by GetEventTypeIndex; prefer the templates below
+	void* ReserveEvent(uint32_t eventTypeIndex, uint32_t& outBufferIndex); // Returns storage for one event in the current frame's buffer or nullptr if the buffer is full; the buffer is not swapped until CommitEvent is called for it
+	void CommitEvent(uint32_t bufferIndex); // Must be called once the reserved event has been written, unless ReserveEvent returned nullptr
+	uint32_t GetDeliveredEventCount(uint32_t eventTypeIndex);
+	const void* GetDeliveredEventChunk(uint32_t eventTypeIndex, uint32_t chunkIndex, uint32_t& outEventCount); // Events are stored contiguously in chunks
+
+	template <class EventType>
+	uint32_t GetEventTypeIndex()
+	{
+		static const uint32_t eventTypeIndex = RegisterEventType(sizeof(EventType), alignof(EventType));
+		return eventTypeIndex;
+	}
+
+	template <class EventType>
+	bool Publish(const EventType& event) // Lock free; safe to call from any thread, events published while the frame ends are delivered in the frame after the next
+	{
+		static_assert(std::is_trivially_destructible<EventType>::value, "Events are discarded without being destroyed");
+		uint32_t bufferIndex;
+		void* storage = ReserveEvent(GetEventTypeIndex<EventType>(), bufferIndex);
+		if (storage == nullptr)
+			return false;
+
+		new (storage) EventType(event);
+		CommitEvent(bufferIndex);
+		return true;
+	}
+
+	template <class EventType>
+	uint32_t GetEventCount() // Events published during the previous frame
+	{
+		return GetDeliveredEventCount(GetEventTypeIndex<EventType>());
+	}
+
+	template <class EventType, class Function>
+	void ForEachEvent(Function function) // Visits the events published during the previous frame in publishing order; all systems and simulation steps of a frame see the same events
+	{
+		uint32_t eventTypeIndex = GetEventTypeIndex<EventType>();
+		uint32_t remainingCount = GetDeliveredEventCount(eventTypeIndex);
+		for (uint32_t chunkIndex = 0; remainingCount > 0; ++chunkIndex)
+		{
+			uint32_t eventCount;
+			const EventType* events = static_cast<const EventType*>(GetDeliveredEventChunk(eventTypeIndex, chunkIndex, eventCount));
+			for (uint32_t i = 0; i < eventCount; ++i)
+			{
+				function(events[i]);
+			}
+			remainingCount -= eventCount;
+		}
+	}
+}
\ No newline at end of file
@@ -22,6 +22,7 @@ namespace MEngine
 
 	TextureID	CreateSubTextureFromTextureData(const TextureData& originalTexture, int32_t upperLeftOffsetX, int32_t upperLeftOffsetY, int32_t lowerRightOffsetX, int32_t lowerRightOffsetY, bool storeCopyInRAM = false);
 	TextureID	CreateTextureFromTextureData(const TextureData& textureData, bool storeCopyInRAM = false);
+	TextureID	CreateTextureRegion(TextureID parentTextureID, int32_t posX, int32_t posY, int32_t width, int32_t height); // Draws part of the parent without copying any pixels; unloaded together with the parent
 
 	const TextureData GetTextureData(TextureID textureID);
 
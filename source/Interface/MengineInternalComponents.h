@@ -21,6 +21,9 @@ namespace MEngine
 	};
 	CREATE_BITFLAG_OPERATOR_SIGNATURES(TextBoxFlags);
 
+	// PosSizeComponent, RectangleRenderingComponent, TextureRenderingComponent and TextComponent are drawn from a render list that is only updated through component events.
+	// Adding and removing them is reported automatically, but edits to their data (including the string a TextComponent points to) are not drawn, nor interpolated
+	// by the simulation thread's snapshots, until reported with NotifyComponentsChanged or MarkComponentsChanged. Debug builds log a warning for unreported changes.
 	class PosSizeComponent : public ComponentBase<PosSizeComponent>
 	{
 	public:
@@ -107,4 +110,11 @@ namespace MEngine
 			}
 		}
 	};
+
+	// The internal component types are registered before any other component type and in this order so their masks are known at compile time
+	constexpr ComponentMask POS_SIZE_COMPONENT_MASK				= 1ULL << 0;
+	constexpr ComponentMask RECTANGLE_RENDERING_COMPONENT_MASK	= 1ULL << 1;
+	constexpr ComponentMask TEXTURE_RENDERING_COMPONENT_MASK	= 1ULL << 2;
+	constexpr ComponentMask BUTTON_COMPONENT_MASK				= 1ULL << 3;
+	constexpr ComponentMask TEXT_COMPONENT_MASK					= 1ULL << 4;
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "MEngineComponent.h"
+#include "MEngineEntityManager.h"
+#include "MEngineTypes.h"
+#include <functional>
+#include <stdint.h>
+
+namespace MEngine // Jobs are run by a pool of worker threads; threads waiting for a job execute other queued jobs in the meantime
+{
+	typedef std::function<void()> JobFunction;
+	typedef std::function<void(int32_t begin, int32_t end)> ParallelForFunction;
+
+	JobID ScheduleJob(JobFunction function, const JobID* dependencies = nullptr, int32_t dependencyCount = 0); // The job will not start until all dependencies have finished
+	JobID ScheduleJob(JobFunction function, JobID dependency);
+	bool WaitForJob(JobID ID);
+	bool IsJobFinished(JobID ID);
+
+	void ParallelFor(int32_t begin, int32_t end, int32_t grainSize, const ParallelForFunction& function); // Splits [begin, end) into batches of grainSize and blocks until all batches have finished
+	int32_t GetWorkerCount();
+
+	// The world of the calling thread is kept in concurrent access while the functions run; structural changes are applied after all batches have finished
+	void ParallelForEntities(ComponentMask componentMask, int32_t grainSize, const std::function<void(EntityID ID)>& function, MaskMatchMode matchMode = MaskMatchMode::Partial);
+	void ParallelForComponentBuffer(uint32_t componentBufferIndex, int32_t grainSize, const std::function<void(Component* component)>& function); // Used by ParallelForComponents; prefer ParallelForComponents<T>
+
+	template <class ComponentType>
+	void ParallelForComponents(int32_t grainSize, const std::function<void(ComponentType& component)>& function)
+	{
+		ParallelForComponentBuffer(ComponentType::GetBufferIndex(), grainSize, [&function](Component* component) { function(*static_cast<ComponentType*>(component)); });
+	}
+}
\ No newline at end of file
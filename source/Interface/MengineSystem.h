@@ -2,21 +2,91 @@
 #include "MEngineTypes.h"
 #include <MUtilityBitset.h>
 #include <stdint.h>
+#include <utility>
+#include <vector>
 
 namespace MEngine
 {
+	constexpr ComponentMask MENGINE_ALL_COMPONENT_TYPES = ~0ULL;
+	constexpr float DEFAULT_TIME_SLICE_BUDGET_MILLISECONDS = 2.0f;
+
 	enum class SystemSettings : MUtility::BitSet
 	{
 		NONE = 0,
 		NO_TRANSITION_RESET = 1 << 0,
+		REACTIVE_ONLY		= 1 << 1, // The system is only updated on frames where it has component events
+		CONTINUOUS_UPDATES	= 1 << 2, // Keeps the engine from idling while the system is active (see MEngine::SetIdleModeEnabled)
 	};
 	CREATE_BITFLAG_OPERATOR_SIGNATURES(SystemSettings);
 
+	struct ComponentEvents // Changes to the observed component types since the system's last update; cleared at the end of each frame the system is updated, so all simulation steps of a frame see the same events
+	{
+		bool IsEmpty() const { return Added.empty() && Removed.empty() && Changed.empty() && !FullRescanRequired; }
+		void Clear() { Added.clear(); Removed.clear(); Changed.clear(); FullRescanRequired = false; }
+
+		std::vector<std::pair<EntityID, ComponentMask>> Added; // The masks only contain component types observed by the system
+		std::vector<std::pair<EntityID, ComponentMask>> Removed; // The entity may no longer exist
+		std::vector<std::pair<EntityID, ComponentMask>> Changed;
+		bool FullRescanRequired = true; // Set when the system is started and when the active world changes; state built from earlier events should be rebuilt from the world
+	};
+
+	class TrackedEntities // Entity list with O(1) insertion, removal and lookup; removing an entity moves the last entity into its position
+	{
+	public:
+		bool Add(EntityID ID); // Returns false if the entity is already tracked
+		bool Remove(EntityID ID); // Returns false if the entity is not tracked
+		bool Contains(EntityID ID) const;
+		void Clear();
+
+		const std::vector<EntityID>& GetEntities() const { return m_Entities; }
+
+	private:
+		std::vector<EntityID>	m_Entities;
+		std::vector<int32_t>	m_Positions; // Indexed by entity ID; -1 for entities that are not tracked
+	};
+
+	class TimeSliceContext // Work that a system spreads over several frames; while the work is in progress System::UpdateTimeSlice is called once per frame on the main thread
+	{
+	public:
+		void Begin(uint64_t workCount = 0); // Starts or restarts the work; the work count only serves as the initial backlog
+		void Finish();
+		bool IsInProgress() const { return m_IsInProgress; }
+
+		bool ShouldYield() const; // True once the current slice has spent its budget; check it between units of work and return from UpdateTimeSlice when it is set
+
+		void SetRemainingWork(uint64_t remainingWorkCount) { m_RemainingWorkCount = remainingWorkCount; } // Reported as the system's backlog
+		uint64_t GetRemainingWork() const { return m_RemainingWorkCount; }
+		uint32_t GetSliceCount() const { return m_SliceCount; } // Slices run since the work began
+		float GetLastSliceMilliseconds() const { return m_LastSliceMilliseconds; }
+
+		void SetBudget(float budgetMilliseconds) { m_BudgetMilliseconds = budgetMilliseconds; }
+		float GetBudget() const { return m_BudgetMilliseconds; }
+
+		void BeginSlice(); // Called by the engine around each call to System::UpdateTimeSlice
+		void EndSlice();
+
+		uint64_t Cursor = 0; // Where the work continues in the next slice; reset by Begin and otherwise only touched by the system
+
+	private:
+		uint64_t	m_SliceStartTicks		= 0;
+		uint64_t	m_SliceDeadlineTicks	= 0;
+		uint64_t	m_RemainingWorkCount	= 0;
+		uint32_t	m_SliceCount			= 0;
+		float		m_LastSliceMilliseconds	= 0.0f;
+		float		m_BudgetMilliseconds	= DEFAULT_TIME_SLICE_BUDGET_MILLISECONDS;
+		bool		m_IsInProgress			= false;
+	};
+
 	class System
 	{
 	public:
-		System(SystemSettings settings = SystemSettings::NONE) : m_SystemSettings(settings) {}
+		// Systems that declare which component types they read and write are updated on worker threads, concurrently with systems they don't conflict with, and must be thread safe
+		// Systems writing to MENGINE_ALL_COMPONENT_TYPES (the default) are updated on the main thread after all earlier systems have finished
+		System(SystemSettings settings = SystemSettings::NONE, ComponentMask observedComponentTypes = MUtility::EMPTY_BITSET,
+			ComponentMask readComponentTypes = MENGINE_ALL_COMPONENT_TYPES, ComponentMask writeComponentTypes = MENGINE_ALL_COMPONENT_TYPES) :
+			m_SystemSettings(settings), m_ObservedComponentTypes(observedComponentTypes), m_ReadComponentTypes(readComponentTypes), m_WriteComponentTypes(writeComponentTypes) {}
 		virtual ~System() {};
+		virtual void Prepare() {}; // Called on a worker thread by PrepareGameMode before the system's game mode is activated; may load files and build entities in the thread's world but must not use the renderer or the active world
 		virtual void Initialize() {};
 		virtual void Shutdown() { m_IsSuspended = false; };
 		virtual void Suspend() { m_IsSuspended = true; };
@@ -24,6 +94,7 @@ namespace MEngine
 
 		virtual void UpdatePresentationLayer(float deltaTime) {};
 		virtual void UpdateSimulationLayer(float timeStep) {};
+		virtual void UpdateTimeSlice(TimeSliceContext& context) {}; // Continues the work begun through GetTimeSliceContext().Begin(); call context.Finish() when done
 
 		bool IsSuspended() { return m_IsSuspended; }
 
@@ -32,9 +103,25 @@ namespace MEngine
 
 		SystemSettings GetSystemSettings() const {return m_SystemSettings;}
 
+		ComponentMask GetObservedComponentTypes() const { return m_ObservedComponentTypes; }
+		ComponentMask GetReadComponentTypes() const { return m_ReadComponentTypes; }
+		ComponentMask GetWriteComponentTypes() const { return m_WriteComponentTypes; }
+		bool HasDeclaredComponentAccess() const { return m_WriteComponentTypes != MENGINE_ALL_COMPONENT_TYPES; }
+		const ComponentEvents& GetComponentEvents() const { return m_ComponentEvents; }
+		ComponentEvents& GetComponentEvents() { return m_ComponentEvents; }
+		const TimeSliceContext& GetTimeSliceContext() const { return m_TimeSliceContext; }
+		TimeSliceContext& GetTimeSliceContext() { return m_TimeSliceContext; }
+
 		private:
 			SystemID m_ID;
 			SystemSettings m_SystemSettings = SystemSettings::NONE;
+			ComponentMask m_ObservedComponentTypes = MUtility::EMPTY_BITSET;
+			ComponentMask m_ReadComponentTypes = MENGINE_ALL_COMPONENT_TYPES;
+			ComponentMask m_WriteComponentTypes = MENGINE_ALL_COMPONENT_TYPES;
+			ComponentEvents m_ComponentEvents;
+			TimeSliceContext m_TimeSliceContext;
 			bool m_IsSuspended = false;
 	};
+
+	void ApplyComponentEvents(const ComponentEvents& events, ComponentMask requiredComponentTypes, TrackedEntities& inOutEntities); // Keeps a list of the entities having all the required component types up to date; O(1) per event
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "MEngineSystem.h"
+#include <functional>
 
 namespace MEngine
 {
@@ -11,6 +12,46 @@ namespace MEngine
 	constexpr uint32_t MENGINE_MIN_SYSTEM_PRIORITY = 100;
 	constexpr uint32_t MENGINE_MAX_SYSTEM_PRIORITY = 10000;
 
+	struct SystemTimeStatistics // Milliseconds spent in one update layer of a system over its most recent updates
+	{
+		float		Last		= 0.0f;
+		float		Average		= 0.0f;
+		float		P95			= 0.0f;
+		float		P99			= 0.0f;
+		float		Max			= 0.0f;
+		uint32_t	SampleCount	= 0;
+	};
+
+	struct SystemStatistics
+	{
+		SystemTimeStatistics Presentation;
+		SystemTimeStatistics Simulation;
+	};
+
+	struct FrameTimeStatistics // Milliseconds over the most recent frames
+	{
+		float		Last					= 0.0f;
+		float		P50						= 0.0f;
+		float		P95						= 0.0f;
+		float		P99						= 0.0f;
+		float		Max						= 0.0f;
+		float		AverageCPUTime			= 0.0f; // Frame time not spent waiting for the renderer to present
+		float		AveragePresentWaitTime	= 0.0f;
+		uint64_t	OverBudgetFrameCount	= 0;
+		uint64_t	FrameCount				= 0;
+	};
+
+	struct SystemBacklog // Progress of the system's time sliced work (see TimeSliceContext)
+	{
+		bool		IsInProgress			= false;
+		uint64_t	RemainingWorkCount		= 0; // As reported by the system
+		uint32_t	SliceCount				= 0; // Frames the current work has been running for
+		float		LastSliceMilliseconds	= 0.0f;
+		float		BudgetMilliseconds		= 0.0f;
+	};
+
+	typedef std::function<void(SystemID ID, float elapsedMilliseconds, float budgetMilliseconds)> SystemBudgetExceededCallback;
+
 	SystemID RegisterSystem(System* system);
 	bool UnregisterSystem(SystemID ID);
 
@@ -19,10 +60,45 @@ namespace MEngine
 
 	GameModeID CreateGameMode(); // TODODB: Make a function for removing game a game mode
 
-	bool AddSystemToGameMode(GameModeID gameModeID, SystemID systemID, uint32_t priority); // TODODB Make a function for removing a system from a game mode
+	bool AddSystemToGameMode(GameModeID gameModeID, SystemID systemID, uint32_t priority, uint32_t simulationStepDivider = 1); // The priority orders systems that are not ordered relative to each other by AddSystemRunsAfter/AddSystemRunsBefore // TODODB Make a function for removing a system from a game mode
+	// The simulation layer of a system added with a step divider above 1 is only updated on every simulationStepDivider:th simulation step and receives the time of all the steps since its last update.
+	// Systems with dividers are staggered so that their updates land on different steps when possible.
+	uint32_t CalcSimulationStepDivider(float updatesPerSecond); // The divider that comes closest to the given update rate at the current simulation speed
+	bool AddSystemRunsAfter(GameModeID gameModeID, SystemID systemID, SystemID runsAfterSystemID); // Both systems must have been added to the game mode; cyclic orderings are logged and ignored
+	bool AddSystemRunsBefore(GameModeID gameModeID, SystemID systemID, SystemID runsBeforeSystemID);
 	bool RequestGameModeChange(GameModeID newGameModeID); // The requested game mode will be activated at the start of next frame
+	// Calls System::Prepare on worker threads for the systems of the game mode that are not running in the active game mode, while the active game mode keeps running.
+	// If a world is supplied, the preparing threads target it and it becomes the active world when the game mode is activated. Activating the game mode waits for unfinished preparation.
+	bool PrepareGameMode(GameModeID gameModeID, WorldID preparationWorldID = WorldID::Invalid());
+	float GetGameModePreparationProgress(GameModeID gameModeID); // Fraction [0, 1] of the game mode's systems that have finished preparing; 1 when no preparation is in progress
+	bool IsGameModePrepared(GameModeID gameModeID);
+
+	void SetSystemStatisticsEnabled(bool enabled); // Systems are only timed while statistics are enabled
+	bool IsSystemStatisticsEnabled();
+	bool GetSystemStatistics(SystemID ID, SystemStatistics& outStatistics);
+	void ResetSystemStatistics();
+	bool SetSystemTimeBudget(SystemID ID, float budgetMilliseconds); // Checked against each presentation and simulation update while statistics are enabled; 0 removes the budget
+	bool SetSystemTimeSliceBudget(SystemID ID, float budgetMilliseconds); // Time each frame's call to System::UpdateTimeSlice may spend before TimeSliceContext::ShouldYield returns true
+	bool GetSystemBacklog(SystemID ID, SystemBacklog& outBacklog);
+	void SetSystemBudgetExceededCallback(SystemBudgetExceededCallback callback); // Called on the thread that updated the system; exceeded budgets are logged when no callback is set
+
+	void SetSimulationThreadEnabled(bool enabled); // Takes effect at the start of the next frame; see below
+	bool IsSimulationThreadEnabled();
+	// While the simulation thread is enabled, simulation layer updates run on their own thread at the simulation rate and rendering uses interpolated snapshots of the world.
+	// The presentation layer and events stay on the main thread. The world may then only be accessed from systems and during MEngine::Update.
+	void SetUnthrottledSimulation(bool unthrottled); // Runs exactly one simulation step per frame regardless of elapsed time; headless servers and load tests can use it to simulate as fast as possible
+	bool IsSimulationUnthrottled(); // When running headless and throttled, each frame sleeps until the next simulation step is due
+	void SetMaxSimulationStepsPerFrame(uint32_t maxSteps); // Simulation time that would need more steps than this in one frame is dropped instead of slowing the frame rate further
+	uint32_t GetMaxSimulationStepsPerFrame();
+	uint32_t GetSimulationStepsLastFrame();
+	float GetDroppedSimulationTime(); // Total simulation time in seconds that has been dropped because of the step cap
+	float GetSimulationInterpolationAlpha(); // How far [0, 1) the current frame is from the last simulation step to the next; presentation systems can use it to interpolate between simulation states
+
+	void GetFrameTimeStatistics(FrameTimeStatistics& outStatistics);
+	void SetFrameTimeBudget(float budgetMilliseconds); // Frames taking longer are counted in FrameTimeStatistics::OverBudgetFrameCount; 0 disables the count
 
 	bool IsSystemIDValid(SystemID ID);
 	bool IsGameModeIDValid(GameModeID ID);
 	bool IsSystemInGameMode(SystemID ID, GameModeID gameModeID);
+	bool CanSystemsOverlap(GameModeID gameModeID, SystemID firstSystemID, SystemID secondSystemID); // True if the systems may be updated concurrently in the game mode's execution plan
 }
\ No newline at end of file
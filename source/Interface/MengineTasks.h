@@ -0,0 +1,87 @@
+#pragma once
+#include "MEngineTypes.h"
+#include <functional>
+#include <stdint.h>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define MENGINE_COROUTINE_TASKS 1
+#include <coroutine>
+#include <exception>
+#include <memory>
+#endif
+
+namespace MEngine // Tasks are multi-frame flows (transitions, staged loading, scripted benchmarks) that run on the main thread at the end of each MEngine::Update
+{
+	enum class TaskWaitType
+	{
+		NextFrame,
+		Seconds,
+		SimulationSteps,
+		Job,
+		Done,
+	};
+
+	struct TaskWait // Returned by a task step to tell the scheduler when the task should continue; waiting tasks are not visited until they are due
+	{
+		TaskWaitType	Type		= TaskWaitType::NextFrame;
+		float			Duration	= 0.0f; // Seconds of real time
+		uint64_t		StepCount	= 0;
+		JobID			Job;
+	};
+
+	inline TaskWait NextFrame() { return TaskWait(); }
+	inline TaskWait Seconds(float seconds) { TaskWait wait; wait.Type = TaskWaitType::Seconds; wait.Duration = seconds; return wait; }
+	inline TaskWait SimulationSteps(uint64_t stepCount) { TaskWait wait; wait.Type = TaskWaitType::SimulationSteps; wait.StepCount = stepCount; return wait; }
+	inline TaskWait JobFinished(JobID ID) { TaskWait wait; wait.Type = TaskWaitType::Job; wait.Job = ID; return wait; } // Assets can be loaded asynchronously by awaiting the job loading them
+	inline TaskWait TaskDone() { TaskWait wait; wait.Type = TaskWaitType::Done; return wait; }
+
+	typedef std::function<TaskWait(uint32_t step)> TaskFunction; // Called with the number of earlier calls so that a task written as a switch over the step resumes where it left off
+
+	TaskID StartTask(TaskFunction function); // The first step runs at the end of the next MEngine::Update; tasks may only be started and cancelled from the main thread
+	bool CancelTask(TaskID ID); // A task may cancel itself
+	bool IsTaskRunning(TaskID ID);
+	uint32_t GetRunningTaskCount();
+
+#if MENGINE_COROUTINE_TASKS
+	void* AllocateTaskFrame(size_t size); // Coroutine frames are pooled by size
+	void FreeTaskFrame(void* frame, size_t size);
+
+	class CoroutineTask // Lets a task be written as a coroutine; co_await NextFrame(), Seconds(x), SimulationSteps(n) or JobFinished(ID) and pass the result to StartTask
+	{
+	public:
+		struct promise_type
+		{
+			CoroutineTask get_return_object() { return CoroutineTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			std::suspend_always await_transform(TaskWait wait) { Wait = wait; return {}; }
+			void return_void() { Wait = TaskDone(); }
+			void unhandled_exception() { std::terminate(); }
+
+			static void* operator new(size_t size) { return AllocateTaskFrame(size); }
+			static void operator delete(void* frame, size_t size) { FreeTaskFrame(frame, size); }
+
+			TaskWait Wait;
+		};
+
+		CoroutineTask(CoroutineTask&& other) noexcept : m_Handle(other.m_Handle) { other.m_Handle = nullptr; }
+		CoroutineTask(const CoroutineTask& other) = delete;
+		~CoroutineTask() { if (m_Handle) m_Handle.destroy(); }
+
+		CoroutineTask& operator=(const CoroutineTask& other) = delete;
+
+		TaskWait Resume() { m_Handle.resume(); return m_Handle.done() ? TaskDone() : m_Handle.promise().Wait; }
+
+	private:
+		explicit CoroutineTask(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+		std::coroutine_handle<promise_type> m_Handle;
+	};
+
+	inline TaskID StartTask(CoroutineTask&& task)
+	{
+		std::shared_ptr<CoroutineTask> coroutine = std::make_shared<CoroutineTask>(std::move(task)); // TaskFunction has to be copyable
+		return StartTask([coroutine](uint32_t step) { return coroutine->Resume(); });
+	}
+#endif
+}
\ No newline at end of file
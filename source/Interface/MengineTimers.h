@@ -0,0 +1,30 @@
+#pragma once
+#include "MEngineTypes.h"
+#include <functional>
+#include <stdint.h>
+
+namespace MEngine
+{
+	enum class TimerClock
+	{
+		Presentation, // Real time with millisecond resolution; callbacks run on the main thread after the presentation layer
+		Simulation, // Simulation steps; callbacks run after the step in which they became due, on the simulation thread if it is enabled
+	};
+
+	struct TimerSettings
+	{
+		TimerClock	Clock			= TimerClock::Presentation;
+		float		RepeatInterval	= 0.0f; // Seconds; 0 fires the timer once
+		SystemID	OwnerSystem; // The timer is cancelled when the system is shut down or unregistered
+		GameModeID	OwnerGameMode; // The timer is cancelled when the game mode is left
+	};
+
+	typedef std::function<void()> TimerCallback;
+
+	TimerID AddTimer(float delaySeconds, TimerCallback callback, const TimerSettings& settings = TimerSettings()); // Simulation delays are rounded up to whole simulation steps
+	bool CancelTimer(TimerID ID); // A timer may cancel itself from its callback
+	bool IsTimerActive(TimerID ID);
+	void CancelSystemTimers(SystemID ID);
+	void CancelGameModeTimers(GameModeID ID);
+	uint32_t GetActiveTimerCount();
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <MUtilityTypes.h>
 
 #define MENGINE_INVALID_COMPONENT_MASK MUTILITY_INVALID_BITMASK_ID
+#define MENGINE_INVALID_COMPONENT_BUFFER_INDEX ~0U
 
 namespace MEngine
 {
@@ -27,12 +28,25 @@ namespace MEngine
 	struct CommandIDTag {};
 	typedef MUtility::StrongID<CommandIDTag, int32_t, -1>	CommandID;
 
+	struct WorldIDTag {};
+	typedef MUtility::StrongID<WorldIDTag, int32_t, -1>		WorldID;
+
+	struct JobIDTag {};
+	typedef MUtility::StrongID<JobIDTag, int64_t, -1>		JobID;
+
+	struct TaskIDTag {};
+	typedef MUtility::StrongID<TaskIDTag, int64_t, -1>		TaskID;
+
+	struct TimerIDTag {};
+	typedef MUtility::StrongID<TimerIDTag, int64_t, -1>		TimerID;
+
 	enum class InitFlags : MUtility::BitSet
 	{
+		None = 0,
+
 		StartWindowCentered = 1 << 0, // Will override WindowPosX and WindowPosY parameters
 		RememberWindowPosition = 1 << 1, // Will override WindowPosX, WindowPosY and StartWindowCentered if there are no config values set for window position
-
-		None,
+		Headless = 1 << 2, // No video subsystem, window or renderer; CreateWindow_ fails and Render does nothing
 	};
 	CREATE_BITFLAG_OPERATOR_SIGNATURES(InitFlags);
 
@@ -10,4 +10,5 @@ namespace MEngine
 
 	bool WindowHasFocus();
 	bool WindowIsHovered();
+	bool WindowIsVisible(); // False while the window is minimized or hidden and when there is no window
 }
\ No newline at end of file
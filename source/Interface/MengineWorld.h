@@ -0,0 +1,27 @@
+#pragma once
+#include "MEngineTypes.h"
+
+namespace MEngine // Each world owns its own entities and component buffers; the entity and component interface always targets the world of the calling thread
+{
+	WorldID CreateWorld(); // Safe to call from any thread; the new world gets a buffer for every registered component type
+	bool DestroyWorld(WorldID ID); // The active world can not be destroyed; make sure no thread still targets the world before destroying it
+
+	bool RequestWorldChange(WorldID newWorldID); // Safe to call from any thread, such as the one loading the next world; the requested world will be activated at the start of next frame
+	bool SetThreadWorld(WorldID ID); // Makes the calling thread target the supplied world; use an invalid ID to go back to targeting the active world
+
+	WorldID GetActiveWorld();
+	WorldID GetThreadWorld(); // Returns the world targeted by the calling thread
+
+	bool IsWorldIDValid(WorldID ID);
+
+	// Concurrency model
+	// Exclusive access (default): one thread at a time may use the world and all changes are applied immediately.
+	// Concurrent access: any number of threads may read entities and components and write component data in place without locking.
+	// Structural changes (creating/destroying entities and adding/removing components) are deferred until EndConcurrentAccess() so no memory is moved while being read.
+	// CreateEntity() still returns a reserved ID immediately, but its entity can not be read until the deferred changes have been applied.
+	// EndConcurrentAccess() is the sync point; call it from the thread that began the phase once all other threads are done with the world.
+	// Registering component types is not allowed during concurrent access. Debug builds log an error when a structural change overlaps with any other access.
+	bool BeginConcurrentAccess(); // Targets the world of the calling thread
+	bool EndConcurrentAccess(); // Applies all deferred structural changes in the order they were made
+	bool IsInConcurrentAccess();
+}
\ No newline at end of file
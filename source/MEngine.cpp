@@ -1,15 +1,23 @@
 #include "Interface/MEngine.h"
 #include "interface/MengineConsole.h"
+#include "Interface/MEngineUtility.h"
+#include "MEngineEventBusInternal.h"
 #include "MEngineGraphicsInternal.h"
 #include "MEngineInputInternal.h"
 #include "MEngineGlobalSystems.h"
 #include "MEngineSystemManagerInternal.h"
+#include "MEngineTasksInternal.h"
+#include "MEngineTimersInternal.h"
+#include "MEngineWorldInternal.h"
+#include "World.h"
 #include <MUtilityLog.h>
 #include <MUtilityString.h>
 #include <MUtilitySystem.h>
 #include <SDL.h>
+#include <atomic>
 #include <cassert>
 #include <iostream>
+#include <mutex>
 
 #define LOG_CATEGORY_GENERAL "MEngine"
 
@@ -20,9 +28,20 @@ namespace MEngine
 {
 	void RegisterMEngineCommands();
 	bool ExecuteSetLogOutputModeCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse);
+	bool ShouldIdle();
+	uint32_t GetIdleMilliseconds();
+	uint64_t GetWorldModificationCount();
 
 	bool m_Initialized		= false;
 	bool m_QuitRequested	= false;
+
+	bool				m_IdleModeEnabled		= false;
+	uint32_t			m_MaxIdleMilliseconds	= DEFAULT_MAX_IDLE_MILLISECONDS;
+	std::atomic<bool>	m_FrameRequested		= false;
+	uint32_t			m_WakeEventType			= static_cast<uint32_t>(-1);
+	bool				m_LastFrameWasIdle		= false;
+	WorldID				m_LastFrameWorldID;
+	uint64_t			m_LastFrameModificationCount = 0;
 }
 
 bool MEngine::Initialize(const char* applicationName, InitFlags initFlags)
@@ -31,7 +50,8 @@ bool MEngine::Initialize(const char* applicationName, InitFlags initFlags)
 
 	assert(MUtilityLog::IsInitialized() && "MutilityLog has not been initialized; call MUtilityLog::Initialize before MEngine::Initialize");
 
-	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+	uint32_t sdlSubsystems = (initFlags & InitFlags::Headless) != 0 ? SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_VIDEO;
+	if (SDL_Init(sdlSubsystems) != 0)
 	{
 		MLOG_ERROR("Initialization failed; SDL_Init Error: " + std::string(SDL_GetError()), LOG_CATEGORY_GENERAL);
 		return false;
@@ -39,6 +59,7 @@ bool MEngine::Initialize(const char* applicationName, InitFlags initFlags)
 
 	MEngineGlobalSystems::Start(applicationName, initFlags);
 	RegisterMEngineCommands();
+	m_WakeEventType = SDL_RegisterEvents(1);
 
 	MLOG_INFO("MEngine initialized successfully", LOG_CATEGORY_GENERAL);
 
@@ -48,6 +69,12 @@ bool MEngine::Initialize(const char* applicationName, InitFlags initFlags)
 
 bool MEngine::CreateWindow_(const char* windowTitle, int32_t windowPosX , int32_t windowPosY, int32_t windowWidth, int32_t windowHeight)
 {
+	if ((GetInitFlags() & InitFlags::Headless) != 0)
+	{
+		MLOG_ERROR("Attempted to create a window while running headless", LOG_CATEGORY_GENERAL);
+		return false;
+	}
+
 	bool result = MEngineGraphics::Initialize(windowTitle, windowPosX, windowPosY, windowWidth, windowHeight); // TODODB: Make this initialize as all the other internal global systems
 	if (!result)
 		MLOG_ERROR("Failed to initialize MEngineGraphics", LOG_CATEGORY_GENERAL);
@@ -78,10 +105,21 @@ bool MEngine::ShouldQuit()
 
 void MEngine::Update()
 {
+	if (ShouldIdle())
+		SDL_WaitEventTimeout(nullptr, GetIdleMilliseconds()); // Returns as soon as an event arrives but leaves it in the queue for the loop below
+
+	bool frameRequested = m_FrameRequested.exchange(false);
+	std::unique_lock<std::mutex> simulationLock = MEngineSystemManager::BeginFrame(); // Keeps the simulation thread, if running, out of the world until this frame's updates are done
+
 	MEngineGlobalSystems::PreEventUpdate();
+	bool receivedEvents = false;
 	SDL_Event event;
 	while (SDL_PollEvent(&event) != 0)
 	{
+		receivedEvents = true;
+		if (event.type == m_WakeEventType)
+			continue;
+
 		if (event.type == SDL_QUIT)
 		{
 			m_QuitRequested = true;
@@ -96,14 +134,51 @@ void MEngine::Update()
 	MEngineSystemManager::Update();
 	MEngineGlobalSystems::PostSystemsUpdate();
 
+	if (MEngineSystemManager::IsSimulationThreadRunning()) // Let the changes made during this frame be rendered without waiting for the next simulation step
+		MEngineGraphics::PublishRenderSnapshot();
+
+	// The frame is idle if it neither received input nor changed any components since the last frame ended, and the next frame has no events to deliver
+	uint64_t modificationCount = GetWorldModificationCount();
+	m_LastFrameWasIdle = !receivedEvents && !frameRequested && GetActiveWorld() == m_LastFrameWorldID && modificationCount == m_LastFrameModificationCount && !MEngineSystemManager::RequiresContinuousUpdates() && !MEngineEventBus::HasDeliveredEvents();
+	m_LastFrameWorldID = GetActiveWorld();
+	m_LastFrameModificationCount = modificationCount;
+
 	MUtilityLog::ClearUnreadMessages();
 }
 
 void MEngine::Render()
 {
+	if (!WindowIsVisible())
+		return;
+
+	if (m_IdleModeEnabled && m_LastFrameWasIdle) // The previous frame already presented the same content
+		return;
+
 	MEngineGraphics::Render();
 }
 
+void MEngine::SetIdleModeEnabled(bool enabled, uint32_t maxIdleMilliseconds)
+{
+	m_IdleModeEnabled		= enabled;
+	m_MaxIdleMilliseconds	= maxIdleMilliseconds;
+}
+
+bool MEngine::IsIdleModeEnabled()
+{
+	return m_IdleModeEnabled;
+}
+
+void MEngine::RequestFrame()
+{
+	m_FrameRequested = true;
+	if (m_IdleModeEnabled && m_WakeEventType != static_cast<uint32_t>(-1))
+	{
+		SDL_Event event = {};
+		event.type = m_WakeEventType;
+		SDL_PushEvent(&event); // Wakes the main thread if it is waiting for events
+	}
+}
+
 // ---------- INTERNAL ----------
 
 void MEngine::RegisterMEngineCommands()
@@ -135,4 +210,24 @@ bool MEngine::ExecuteSetLogOutputModeCommand(const std::string* parameters, int3
 		*outResponse = "Wrong number of parameters supplied";
 
 	return result;
+}
+
+bool MEngine::ShouldIdle()
+{
+	if (!m_IdleModeEnabled || !m_LastFrameWasIdle || m_FrameRequested || MEngineSystemManager::IsSimulationThreadRunning() || MEngineTasks::HasPendingFrameTasks())
+		return false;
+
+	return GetActiveWorld() == m_LastFrameWorldID && GetWorldModificationCount() == m_LastFrameModificationCount; // Changes made between frames need to be shown
+}
+
+uint32_t MEngine::GetIdleMilliseconds()
+{
+	// Wake up in time to fire the next presentation timer or resume the next sleeping task
+	uint32_t milliseconds = MEngineTimers::GetMillisecondsUntilNextPresentationTimer(m_MaxIdleMilliseconds);
+	return MEngineTasks::GetMillisecondsUntilNextTimerTask(milliseconds);
+}
+
+uint64_t MEngine::GetWorldModificationCount()
+{
+	return MEngineWorld::GetWorld(GetActiveWorld())->GetModificationCount();
 }
\ No newline at end of file
@@ -1,15 +1,28 @@
 #include "Interface/MEngineComponentManager.h"
 #include "ComponentBuffer.h"
 #include "MEngineComponentManagerInternal.h"
+#include "MEngineWorldInternal.h"
+#include "World.h"
 #include <MUtilityLog.h>
 #include <MUtilityMath.h>
+#include <mutex>
 #include <vector>
 
 #define LOG_CATEGORY_COMPONENT_MANAGER "ComponentManager"
 
 namespace MEngineComponentManager
 {
-	std::vector<MEngine::ComponentBuffer*>* m_Buffers;
+	struct ComponentTypeDescription // Everything needed to create a buffer for the component type in a new world
+	{
+		MEngine::Component*	TemplateComponent	= nullptr;
+		uint32_t			ByteSize			= 0;
+		uint32_t			MaxCount			= 0;
+		std::string			ComponentName;
+		MEngine::ComponentMask ComponentType	= MENGINE_INVALID_COMPONENT_MASK;
+	};
+
+	std::vector<ComponentTypeDescription>* m_ComponentTypes;
+	std::mutex m_ComponentTypesLock;
 	MUtility::MUtilityBitMaskIDBank m_BitMaskIDBank;
 }
 
@@ -28,7 +41,20 @@ MEngine::ComponentMask MEngine::RegisterComponentType(const MEngine::Component&
 		return MENGINE_INVALID_COMPONENT_MASK;
 	}
 #endif
-	m_Buffers->push_back(new ComponentBuffer(templateComponent, templateComponentSize, maxCount, componentName, componentMask));
+
+	ComponentTypeDescription description;
+	description.TemplateComponent	= static_cast<Component*>(malloc(templateComponentSize));
+	description.ByteSize			= templateComponentSize;
+	description.MaxCount			= maxCount;
+	description.ComponentName		= componentName;
+	description.ComponentType		= componentMask;
+	memcpy(description.TemplateComponent, &templateComponent, templateComponentSize);
+
+	m_ComponentTypesLock.lock();
+	m_ComponentTypes->push_back(description);
+	m_ComponentTypesLock.unlock();
+
+	MEngineWorld::AddComponentTypeToWorlds(componentMask);
 
 	return componentMask;
 }
@@ -48,24 +74,31 @@ bool MEngine::UnregisterComponentType(ComponentMask componentType) // TODODB: De
 	}
 #endif
 
-	for (int i = 0; i < m_Buffers->size(); ++i)
+	bool result = false;
+	m_ComponentTypesLock.lock();
+	for (int i = 0; i < m_ComponentTypes->size(); ++i)
 	{
-		if ((*m_Buffers)[i]->ComponentType == componentType)
+		if ((*m_ComponentTypes)[i].ComponentType == componentType)
 		{
 			if (m_BitMaskIDBank.ReturnID(componentType))
 			{
-				m_Buffers->erase(m_Buffers->begin() + i);
-				return true;
+				free((*m_ComponentTypes)[i].TemplateComponent);
+				m_ComponentTypes->erase(m_ComponentTypes->begin() + i);
+				result = true;
 			}
 			else
-			{
-				MLOG_WARNING("Failed to return the component mask for component \"" << (*m_Buffers)[i]->ComponentName << "\"; the component type will not be unregistered", LOG_CATEGORY_COMPONENT_MANAGER);
-				return false;
-			}
+				MLOG_WARNING("Failed to return the component mask for component \"" << (*m_ComponentTypes)[i].ComponentName << "\"; the component type will not be unregistered", LOG_CATEGORY_COMPONENT_MANAGER);
+
+			m_ComponentTypesLock.unlock();
+
+			if (result)
+				MEngineWorld::RemoveComponentTypeFromWorlds(componentType); // Called without holding the type lock since world creation takes the locks in the opposite order
+			return result;
 		}
 	}
+	m_ComponentTypesLock.unlock();
 
-	MLOG_ERROR("Failed to find the component buffer for component mask " << MUtility::BitSetToString(componentType), LOG_CATEGORY_COMPONENT_MANAGER);
+	MLOG_ERROR("Failed to find the component type description for component mask " << MUtility::BitSetToString(componentType), LOG_CATEGORY_COMPONENT_MANAGER);
 	return false;
 }
 
@@ -85,13 +118,11 @@ MUtility::Byte* MEngine::GetComponentBuffer(ComponentMask componentType, const C
 	}
 #endif
 
-	for (int i = 0; i < m_Buffers->size(); ++i)
+	const ComponentBuffer* buffer = MEngineWorld::GetCurrentWorld()->GetComponentBuffer(componentType);
+	if (buffer != nullptr)
 	{
-		if ((*m_Buffers)[i]->ComponentType == componentType)
-		{
-			outIDs = &(*m_Buffers)[i]->GetIDs();
-			return (*m_Buffers)[i]->GetBuffer();
-		}
+		outIDs = &buffer->GetIDs();
+		return buffer->GetBuffer();
 	}
 
 	MLOG_ERROR("Failed to find the component buffer for component mask " << MUtility::BitSetToString(componentType), LOG_CATEGORY_COMPONENT_MANAGER);
@@ -102,32 +133,38 @@ MUtility::Byte* MEngine::GetComponentBuffer(ComponentMask componentType, const C
 
 void MEngineComponentManager::Initialize()
 {
-	m_Buffers = new std::vector<MEngine::ComponentBuffer*>();
+	m_ComponentTypes = new std::vector<ComponentTypeDescription>();
 }
 
 void MEngineComponentManager::Shutdown()
 {
-	for (int i = 0; i < m_Buffers->size(); ++i)
+	for (int i = 0; i < m_ComponentTypes->size(); ++i)
 	{
-		delete (*m_Buffers)[i];
+		free((*m_ComponentTypes)[i].TemplateComponent);
 	}
-	delete m_Buffers;
+	delete m_ComponentTypes;
 }
 
-uint32_t MEngineComponentManager::AllocateComponent(MEngine::ComponentMask componentType, EntityID owner)
+void MEngineComponentManager::CreateComponentBuffers(World& world)
 {
-	uint32_t componentBufferIndex = MUtilityMath::FastLog2(componentType);
-	return (*m_Buffers)[componentBufferIndex]->AllocateComponent(owner);
-}
-
-bool MEngineComponentManager::ReturnComponent(MEngine::ComponentMask componentType, uint32_t componentIndex)
-{
-	uint32_t componentBufferIndex = MUtilityMath::FastLog2(componentType);
-	return (*m_Buffers)[componentBufferIndex]->ReturnComponent(componentIndex);
+	std::lock_guard<std::mutex> lock(m_ComponentTypesLock);
+	for (int i = 0; i < m_ComponentTypes->size(); ++i)
+	{
+		const ComponentTypeDescription& description = (*m_ComponentTypes)[i];
+		world.AddComponentBuffer(new ComponentBuffer(*description.TemplateComponent, description.ByteSize, description.MaxCount, description.ComponentName.c_str(), description.ComponentType));
+	}
 }
 
-MEngine::Component* MEngineComponentManager::GetComponent(MEngine::ComponentMask componentType, uint32_t componentIndex)
+void MEngineComponentManager::CreateComponentBuffer(World& world, ComponentMask componentType)
 {
-	uint32_t componentBufferIndex = MUtilityMath::FastLog2(componentType);
-	return (*m_Buffers)[componentBufferIndex]->GetComponent(componentIndex);
+	std::lock_guard<std::mutex> lock(m_ComponentTypesLock);
+	for (int i = 0; i < m_ComponentTypes->size(); ++i)
+	{
+		const ComponentTypeDescription& description = (*m_ComponentTypes)[i];
+		if (description.ComponentType == componentType)
+		{
+			world.AddComponentBuffer(new ComponentBuffer(*description.TemplateComponent, description.ByteSize, description.MaxCount, description.ComponentName.c_str(), description.ComponentType));
+			return;
+		}
+	}
 }
\ No newline at end of file
@@ -3,6 +3,11 @@
 #include "Interface/MEngineComponent.h"
 #include <MUtilityByte.h>
 
+namespace MEngine
+{
+	class World;
+}
+
 namespace MEngineComponentManager
 {
 	constexpr uint32_t MAX_COMPONENTS = sizeof(MEngine::ComponentMask) * MUtility::BITS_PER_BYTE;
@@ -10,8 +15,6 @@ namespace MEngineComponentManager
 	void Initialize();
 	void Shutdown();
 
-	uint32_t AllocateComponent(MEngine::ComponentMask componentType, MEngine::EntityID owner); // TODODB: See if we can get rid of the owner argument (Required for updated the owner if the component is moved when another component is returned)
-	bool ReturnComponent(MEngine::ComponentMask componentType, uint32_t componentIndex);
-
-	MEngine::Component* GetComponent(MEngine::ComponentMask componentType, uint32_t componentIndex);
+	void CreateComponentBuffers(MEngine::World& world); // Creates a buffer for every registered component type in the supplied world
+	void CreateComponentBuffer(MEngine::World& world, MEngine::ComponentMask componentType);
 }
\ No newline at end of file
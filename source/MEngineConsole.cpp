@@ -48,6 +48,7 @@ namespace MEngine
 	MEngine::FontID m_OutputFont;
 	bool m_IsActive = true;
 	bool m_InitializedByHost = false;
+	bool m_WasActiveBeforeWorldChange = false;
 	int32_t m_OutputTextBoxOriginalHeight = -1;
 }
 
@@ -307,12 +308,12 @@ bool MEngine::SetConsoleActive(bool active)
 	if (m_IsActive == active)
 		return false;
 
-	RectangleRenderingComponent* mainBackground = static_cast<RectangleRenderingComponent*>(GetComponent(m_BackgroundID, RectangleRenderingComponent::GetComponentMask()));
-	TextComponent* outputText = static_cast<TextComponent*>(GetComponent(m_OutputTextboxID, TextComponent::GetComponentMask()));
-	RectangleRenderingComponent* outputTextBackground = static_cast<RectangleRenderingComponent*>(GetComponent(m_OutputTextboxID, RectangleRenderingComponent::GetComponentMask()));
-	TextComponent* inputText = static_cast<TextComponent*>(GetComponent(m_InputTextboxID, TextComponent::GetComponentMask()));
-	RectangleRenderingComponent* inputTextbackground = static_cast<RectangleRenderingComponent*>(GetComponent(m_InputTextboxID, RectangleRenderingComponent::GetComponentMask()));
-	ButtonComponent* inputButton = static_cast<ButtonComponent*>(GetComponent(m_InputTextboxID, ButtonComponent::GetComponentMask()));
+	RectangleRenderingComponent* mainBackground = GetComponent<RectangleRenderingComponent>(m_BackgroundID);
+	TextComponent* outputText = GetComponent<TextComponent>(m_OutputTextboxID);
+	RectangleRenderingComponent* outputTextBackground = GetComponent<RectangleRenderingComponent>(m_OutputTextboxID);
+	TextComponent* inputText = GetComponent<TextComponent>(m_InputTextboxID);
+	RectangleRenderingComponent* inputTextbackground = GetComponent<RectangleRenderingComponent>(m_InputTextboxID);
+	ButtonComponent* inputButton = GetComponent<ButtonComponent>(m_InputTextboxID);
 	if (active)
 	{
 		mainBackground->RenderIgnore		= false;
@@ -333,6 +334,9 @@ bool MEngine::SetConsoleActive(bool active)
 		inputButton->IsActive				= false;
 		inputText->StopEditing();
 	}
+	NotifyComponentsChanged(m_BackgroundID, RECTANGLE_RENDERING_COMPONENT_MASK);
+	NotifyComponentsChanged(m_OutputTextboxID, TEXT_COMPONENT_MASK | RECTANGLE_RENDERING_COMPONENT_MASK);
+	NotifyComponentsChanged(m_InputTextboxID, TEXT_COMPONENT_MASK | RECTANGLE_RENDERING_COMPONENT_MASK | BUTTON_COMPONENT_MASK);
 	m_IsActive = active;
 	return true;
 }
@@ -375,8 +379,8 @@ void MEngineConsole::Update()
 			
 		if (m_IsActive)
 		{
-			const TextComponent* inputText = static_cast<const TextComponent*>(GetComponent(m_InputTextboxID, TextComponent::GetComponentMask()));
-			TextComponent* outputText = static_cast<TextComponent*>(GetComponent(m_OutputTextboxID, TextComponent::GetComponentMask()));
+			const TextComponent* inputText = GetComponent<TextComponent>(m_InputTextboxID);
+			TextComponent* outputText = GetComponent<TextComponent>(m_OutputTextboxID);
 			int32_t initialTextHeight = GetTextHeight(outputText->FontID, outputText->Text->c_str());
 			int32_t initialTextLength = static_cast<int32_t>(outputText->Text->length());
 
@@ -402,8 +406,10 @@ void MEngineConsole::Update()
 
 			if (outputText->Text->length() > initialTextLength)
 			{
+				MarkComponentsChanged<TextComponent>(m_OutputTextboxID);
+
 				// Move the console along with the output text
-				PosSizeComponent* outputTextPos = static_cast<PosSizeComponent*>(GetComponent(m_OutputTextboxID, PosSizeComponent::GetComponentMask()));
+				PosSizeComponent* outputTextPos = GetComponent<PosSizeComponent>(m_OutputTextboxID);
 				int32_t AddedTextHeight = GetTextHeight(outputText->FontID, outputText->Text->c_str()) - initialTextHeight;
 				int32_t lineHeight = GetLineHeight(outputText->FontID);
 
@@ -426,6 +432,30 @@ void MEngineConsole::Update()
 	}
 }
 
+void MEngineConsole::PreWorldChange()
+{
+	if (!m_InitializedByHost)
+		return;
+
+	// Carry the output text over to the console in the new world
+	const TextComponent* outputText = GetComponent<TextComponent>(m_OutputTextboxID);
+	*m_StoredLogMessages = *outputText->Text + *m_StoredLogMessages;
+
+	m_WasActiveBeforeWorldChange = m_IsActive;
+	DestroyComponents();
+}
+
+void MEngineConsole::PostWorldChange()
+{
+	if (!m_InitializedByHost)
+		return;
+
+	m_IsActive = true; // Makes CreateComponents hide the newly created console
+	CreateComponents();
+	if (m_WasActiveBeforeWorldChange)
+		SetConsoleActive(true);
+}
+
 // ---------- LOCAL ----------
 
 void CreateComponents()
@@ -436,16 +466,16 @@ void CreateComponents()
 	int32_t fullWidth = GetWindowWidth();
 
 	m_BackgroundID = CreateEntity();
-	AddComponentsToEntity(m_BackgroundID, PosSizeComponent::GetComponentMask() | RectangleRenderingComponent::GetComponentMask());
+	AddComponents<PosSizeComponent, RectangleRenderingComponent>(m_BackgroundID);
 
-	PosSizeComponent* posSize = static_cast<PosSizeComponent*>(GetComponent(m_BackgroundID, PosSizeComponent::GetComponentMask()));
+	PosSizeComponent* posSize = GetComponent<PosSizeComponent>(m_BackgroundID);
 	posSize->PosX = 0;
 	posSize->PosY = 0;
 	posSize->PosZ = 1U;
 	posSize->Width = fullWidth;
 	posSize->Height = m_OutputTextBoxOriginalHeight;
 
-	RectangleRenderingComponent* background = static_cast<RectangleRenderingComponent*>(GetComponent(m_BackgroundID, RectangleRenderingComponent::GetComponentMask()));
+	RectangleRenderingComponent* background = GetComponent<RectangleRenderingComponent>(m_BackgroundID);
 	background->FillColor = ColorData(0, 128, 0, 128);
 
 	m_OutputTextboxID = CreateTextBox(0, 0, fullWidth, m_OutputTextBoxOriginalHeight - INPUT_TEXTBOX_HEIGHT, m_OutputFont, 0U, "", TextAlignment::TopLeft, TextBoxFlags::Scrollable);
@@ -462,6 +492,10 @@ void DestroyComponents()
 		DestroyEntity(m_OutputTextboxID);
 	if (m_InputTextboxID.IsValid())
 		DestroyEntity(m_InputTextboxID);
+
+	m_BackgroundID.Invalidate();
+	m_OutputTextboxID.Invalidate();
+	m_InputTextboxID.Invalidate();
 }
 
 bool ExecuteHelpCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse)
@@ -6,4 +6,7 @@ namespace MEngineConsole
 	void shutdown();
 
 	void Update();
+
+	void PreWorldChange();
+	void PostWorldChange();
 }
\ No newline at end of file
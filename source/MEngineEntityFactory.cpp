@@ -12,22 +12,22 @@ EntityID MEngine::CreateButton(int32_t posX, int32_t posY, int32_t width, int32_
 	EntityID ID = CreateEntity();
 	AddComponentsToEntity(ID, BUTTON_ENTITY_MASK);
 
-	PosSizeComponent* posSizeComponent = static_cast<PosSizeComponent*>(GetComponent(ID, PosSizeComponent::GetComponentMask()));
+	PosSizeComponent* posSizeComponent = GetComponent<PosSizeComponent>(ID);
 	posSizeComponent->PosX = posX;
 	posSizeComponent->PosY = posY;
 	posSizeComponent->PosZ = posZ;
 	posSizeComponent->Width = width;
 	posSizeComponent->Height = height;
 
-	ButtonComponent* buttonComponent = static_cast<ButtonComponent*>(GetComponent(ID, ButtonComponent::GetComponentMask()));
+	ButtonComponent* buttonComponent = GetComponent<ButtonComponent>(ID);
 	buttonComponent->Callback	= new std::function<void()>(callback);
 
-	TextureRenderingComponent* textureComponent = static_cast<TextureRenderingComponent*>(GetComponent(ID, TextureRenderingComponent::GetComponentMask()));
+	TextureRenderingComponent* textureComponent = GetComponent<TextureRenderingComponent>(ID);
 	textureComponent->TextureID = textureID;
 	if (!textureID.IsValid())
 		textureComponent->RenderIgnore = true;
 
-	TextComponent* textComponent = static_cast<TextComponent*>(GetComponent(ID, TextComponent::GetComponentMask()));
+	TextComponent* textComponent = GetComponent<TextComponent>(ID);
 	textComponent->Text = new std::string(text);
 	textComponent->DefaultText = new std::string(text);
 	textComponent->FontID = fontID;
@@ -42,18 +42,18 @@ EntityID MEngine::CreateTextBox(int32_t posX, int32_t posY, int32_t width, int32
 	ComponentMask entityMask = (editFlags & TextBoxFlags::Editable) != 0 ? TEXT_BOX_EDITABLE_ENTITY_MASK : TEXT_BOX_ENTITY_MASK;
 	AddComponentsToEntity(ID, entityMask);
 
-	PosSizeComponent* posSizeComponent = static_cast<PosSizeComponent*>(GetComponent(ID, PosSizeComponent::GetComponentMask()));
+	PosSizeComponent* posSizeComponent = GetComponent<PosSizeComponent>(ID);
 	posSizeComponent->PosX		= posX;
 	posSizeComponent->PosY		= posY;
 	posSizeComponent->PosZ		= posZ;
 	posSizeComponent->Width		= width;
 	posSizeComponent->Height	= height;
 
-	RectangleRenderingComponent* rectangleComponent = static_cast<RectangleRenderingComponent*>(GetComponent(ID, RectangleRenderingComponent::GetComponentMask()));
+	RectangleRenderingComponent* rectangleComponent = GetComponent<RectangleRenderingComponent>(ID);
 	rectangleComponent->FillColor	= backgroundColor;
 	rectangleComponent->BorderColor = borderColor;
 
-	TextComponent* textComponent	= static_cast<TextComponent*>(GetComponent(ID, TextComponent::GetComponentMask()));
+	TextComponent* textComponent	= GetComponent<TextComponent>(ID);
 	textComponent->Text				= new std::string(text);
 	textComponent->DefaultText		= new std::string(text);
 	textComponent->FontID			= fontID;
@@ -62,7 +62,7 @@ EntityID MEngine::CreateTextBox(int32_t posX, int32_t posY, int32_t width, int32
 
 	if ((editFlags & TextBoxFlags::Editable) != 0)
 	{
-		ButtonComponent* buttonComponent = static_cast<ButtonComponent*>(GetComponent(ID, ButtonComponent::GetComponentMask()));
+		ButtonComponent* buttonComponent = GetComponent<ButtonComponent>(ID);
 		buttonComponent->Callback = new std::function<void()>(std::bind(&TextComponent::StartEditing, *textComponent));
 	}
 
@@ -79,12 +79,13 @@ bool MEngine::ShowButton(EntityID ID)
 		return false;
 	}
 #endif
-	TextureRenderingComponent* textureComp = static_cast<TextureRenderingComponent*>(MEngine::GetComponent(ID, TextureRenderingComponent::GetComponentMask()));
+	TextureRenderingComponent* textureComp = MEngine::GetComponent<TextureRenderingComponent>(ID);
 	if (textureComp->RenderIgnore)
 	{
-		static_cast<ButtonComponent*>(MEngine::GetComponent(ID, ButtonComponent::GetComponentMask()))->IsActive = true;
-		static_cast<TextComponent*>(MEngine::GetComponent(ID, TextComponent::GetComponentMask()))->RenderIgnore = false;
+		MEngine::GetComponent<ButtonComponent>(ID)->IsActive = true;
+		MEngine::GetComponent<TextComponent>(ID)->RenderIgnore = false;
 		textureComp->RenderIgnore = false;
+		MarkComponentsChanged<ButtonComponent, TextComponent, TextureRenderingComponent>(ID);
 	}
 
 	return !textureComp->RenderIgnore;
@@ -99,12 +100,13 @@ bool MEngine::HideButton(EntityID ID)
 		return false;
 	}
 #endif
-	TextureRenderingComponent* textureComp = static_cast<TextureRenderingComponent*>(MEngine::GetComponent(ID, TextureRenderingComponent::GetComponentMask()));
+	TextureRenderingComponent* textureComp = MEngine::GetComponent<TextureRenderingComponent>(ID);
 	if (!textureComp->RenderIgnore)
 	{
-		static_cast<ButtonComponent*>(MEngine::GetComponent(ID, ButtonComponent::GetComponentMask()))->IsActive = false;
-		static_cast<TextComponent*>(MEngine::GetComponent(ID, TextComponent::GetComponentMask()))->RenderIgnore = true;
+		MEngine::GetComponent<ButtonComponent>(ID)->IsActive = false;
+		MEngine::GetComponent<TextComponent>(ID)->RenderIgnore = true;
 		textureComp->RenderIgnore = true;
+		MarkComponentsChanged<ButtonComponent, TextComponent, TextureRenderingComponent>(ID);
 	}
 	return textureComp->RenderIgnore;
 }
@@ -118,13 +120,15 @@ bool MEngine::ShowTextBox(EntityID ID)
 		return false;
 	}
 #endif
-	TextComponent* textComp = static_cast<TextComponent*>(MEngine::GetComponent(ID, TextComponent::GetComponentMask()));
+	TextComponent* textComp = MEngine::GetComponent<TextComponent>(ID);
 	if (textComp->RenderIgnore)
 	{
 		textComp->RenderIgnore = false;
-		static_cast<RectangleRenderingComponent*>(MEngine::GetComponent(ID, RectangleRenderingComponent::GetComponentMask()))->RenderIgnore = false;
+		MEngine::GetComponent<RectangleRenderingComponent>(ID)->RenderIgnore = false;
 		if ((GetComponentMask(ID) & TEXT_BOX_EDITABLE_ENTITY_MASK) == TEXT_BOX_EDITABLE_ENTITY_MASK)
-			static_cast<ButtonComponent*>(MEngine::GetComponent(ID, ButtonComponent::GetComponentMask()))->IsActive = true;
+			MEngine::GetComponent<ButtonComponent>(ID)->IsActive = true;
+
+		NotifyComponentsChanged(ID, GetComponentMask(ID) & TEXT_BOX_EDITABLE_ENTITY_MASK);
 	}
 	return !textComp->RenderIgnore;
 }
@@ -139,13 +143,15 @@ bool MEngine::HideTextBox(EntityID ID)
 	}
 #endif
 
-	TextComponent* textComp = static_cast<TextComponent*>(MEngine::GetComponent(ID, TextComponent::GetComponentMask()));
+	TextComponent* textComp = MEngine::GetComponent<TextComponent>(ID);
 	if (!textComp->RenderIgnore)
 	{
 		textComp->RenderIgnore = true;
-		static_cast<RectangleRenderingComponent*>(MEngine::GetComponent(ID, RectangleRenderingComponent::GetComponentMask()))->RenderIgnore = true;
+		MEngine::GetComponent<RectangleRenderingComponent>(ID)->RenderIgnore = true;
 		if ((GetComponentMask(ID) & TEXT_BOX_EDITABLE_ENTITY_MASK) == TEXT_BOX_EDITABLE_ENTITY_MASK)
-			static_cast<ButtonComponent*>(MEngine::GetComponent(ID, ButtonComponent::GetComponentMask()))->IsActive = false;
+			MEngine::GetComponent<ButtonComponent>(ID)->IsActive = false;
+
+		NotifyComponentsChanged(ID, GetComponentMask(ID) & TEXT_BOX_EDITABLE_ENTITY_MASK);
 	}
 	return textComp->RenderIgnore;
 }
\ No newline at end of file
@@ -2,10 +2,7 @@
 #include "Interface/MEngineEntityManager.h"
 #include <vector>
 
-namespace MEngineEntityManager
+namespace MEngineEntityManager // Entity state is owned by MEngine::World; see MEngineWorldInternal.h
 {
-	void Initialize();
-	void Shutdown();
-
 	void UpdateComponentIndex(MEngine::EntityID ID, MEngine::ComponentMask componentType, uint32_t newComponentIndex);
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "Interface/MEngineEventBus.h"
+#include "MEngineEventBusInternal.h"
+#include <MUtilityLog.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#define LOG_CATEGORY_EVENT_BUS "MEngineEventBus"
+
+using namespace MEngine;
+
+namespace MEngineEventBus
+{
+	constexpr uint32_t MAX_EVENT_TYPES			= 256;
+	constexpr uint32_t EVENTS_PER_CHUNK			= 256;
+	constexpr uint32_t MAX_CHUNKS_PER_BUFFER	= 1024; // Limits each event type to 262144 events per frame
+
+	struct EventBuffer // Chunks are allocated on demand and kept between frames
+	{
+		std::atomic<uint32_t>	ReservedCount = 0; // May exceed the capacity when events were dropped
+		std::atomic<uint8_t*>	Chunks[MAX_CHUNKS_PER_BUFFER] = {};
+	};
+
+	struct EventTypeData
+	{
+		uint32_t	EventSize		= 0;
+		uint32_t	EventAlignment	= 0;
+		EventBuffer	Buffers[2];
+	};
+
+	uint8_t* GetOrCreateChunk(const EventTypeData& eventType, EventBuffer& buffer, uint32_t chunkIndex);
+
+	// Type registrations outlive the engine since the indices are cached in function local statics
+	EventTypeData			m_EventTypes[MAX_EVENT_TYPES];
+	std::atomic<uint32_t>	m_EventTypeCount		= 0;
+	std::mutex				m_RegistrationLock;
+	std::atomic<uint32_t>	m_PublishBufferIndex	= 0; // The other buffer holds the delivered events
+	std::atomic<uint32_t>	m_WritingPublisherCounts[2] = {}; // Events reserved but not yet committed per buffer; SwapBuffers waits for these
+}
+
+using namespace MEngineEventBus;
+
+// ---------- INTERFACE ----------
+
+uint32_t MEngine::RegisterEventType(uint32_t eventSize, uint32_t eventAlignment)
+{
+	std::lock_guard<std::mutex> lock(m_RegistrationLock);
+	uint32_t eventTypeIndex = m_EventTypeCount;
+	if (eventTypeIndex >= MAX_EVENT_TYPES)
+	{
+		MLOG_ERROR("Too many event types have been registered; max = " << MAX_EVENT_TYPES, LOG_CATEGORY_EVENT_BUS);
+		return MAX_EVENT_TYPES;
+	}
+
+	m_EventTypes[eventTypeIndex].EventSize		= eventSize;
+	m_EventTypes[eventTypeIndex].EventAlignment	= eventAlignment;
+	++m_EventTypeCount;
+	return eventTypeIndex;
+}
+
+void* MEngine::ReserveEvent(uint32_t eventTypeIndex, uint32_t& outBufferIndex)
+{
+	if (eventTypeIndex >= MAX_EVENT_TYPES)
+		return nullptr;
+
+	// Register as a writer before touching the buffer; if it was swapped in the meantime the swap may not have seen the registration, so retry on the new one
+	uint32_t bufferIndex;
+	while (true)
+	{
+		bufferIndex = m_PublishBufferIndex;
+		++m_WritingPublisherCounts[bufferIndex];
+		if (bufferIndex == m_PublishBufferIndex)
+			break;
+
+		--m_WritingPublisherCounts[bufferIndex];
+	}
+
+	EventTypeData& eventType = m_EventTypes[eventTypeIndex];
+	EventBuffer& buffer = eventType.Buffers[bufferIndex];
+	uint32_t eventIndex = buffer.ReservedCount++;
+	if (eventIndex >= EVENTS_PER_CHUNK * MAX_CHUNKS_PER_BUFFER)
+	{
+		--m_WritingPublisherCounts[bufferIndex];
+		if (eventIndex == EVENTS_PER_CHUNK * MAX_CHUNKS_PER_BUFFER) // Only log the first dropped event of the frame
+			MLOG_WARNING("Event buffer is full; events of type " << eventTypeIndex << " will be dropped until the end of the frame", LOG_CATEGORY_EVENT_BUS);
+		return nullptr;
+	}
+
+	outBufferIndex = bufferIndex;
+	uint8_t* chunk = GetOrCreateChunk(eventType, buffer, eventIndex / EVENTS_PER_CHUNK);
+	return chunk + (eventIndex % EVENTS_PER_CHUNK) * eventType.EventSize;
+}
+
+void MEngine::CommitEvent(uint32_t bufferIndex)
+{
+	--m_WritingPublisherCounts[bufferIndex];
+}
+
+uint32_t MEngine::GetDeliveredEventCount(uint32_t eventTypeIndex)
+{
+	if (eventTypeIndex >= MAX_EVENT_TYPES)
+		return 0;
+
+	uint32_t reservedCount = m_EventTypes[eventTypeIndex].Buffers[1 - m_PublishBufferIndex].ReservedCount;
+	return reservedCount < EVENTS_PER_CHUNK * MAX_CHUNKS_PER_BUFFER ? reservedCount : EVENTS_PER_CHUNK * MAX_CHUNKS_PER_BUFFER;
+}
+
+const void* MEngine::GetDeliveredEventChunk(uint32_t eventTypeIndex, uint32_t chunkIndex, uint32_t& outEventCount)
+{
+	uint32_t deliveredCount = GetDeliveredEventCount(eventTypeIndex);
+	uint32_t firstEvent = chunkIndex * EVENTS_PER_CHUNK;
+	if (firstEvent >= deliveredCount)
+	{
+		outEventCount = 0;
+		return nullptr;
+	}
+
+	outEventCount = deliveredCount - firstEvent < EVENTS_PER_CHUNK ? deliveredCount - firstEvent : EVENTS_PER_CHUNK;
+	return m_EventTypes[eventTypeIndex].Buffers[1 - m_PublishBufferIndex].Chunks[chunkIndex];
+}
+
+// ---------- INTERNAL ----------
+
+void MEngineEventBus::Initialize()
+{
+	m_PublishBufferIndex = 0;
+}
+
+void MEngineEventBus::Shutdown()
+{
+	for (uint32_t i = 0; i < m_EventTypeCount; ++i)
+	{
+		for (int j = 0; j < 2; ++j)
+		{
+			EventBuffer& buffer = m_EventTypes[i].Buffers[j];
+			for (int k = 0; k < MAX_CHUNKS_PER_BUFFER; ++k)
+			{
+				uint8_t* chunk = buffer.Chunks[k].exchange(nullptr);
+				if (chunk != nullptr)
+					::operator delete(chunk, std::align_val_t(m_EventTypes[i].EventAlignment));
+			}
+			buffer.ReservedCount = 0;
+		}
+	}
+}
+
+void MEngineEventBus::SwapBuffers()
+{
+	uint32_t publishBufferIndex = m_PublishBufferIndex;
+	uint32_t deliveredBufferIndex = 1 - publishBufferIndex;
+	for (uint32_t i = 0; i < m_EventTypeCount; ++i)
+	{
+		m_EventTypes[i].Buffers[deliveredBufferIndex].ReservedCount = 0;
+	}
+	m_PublishBufferIndex = deliveredBufferIndex;
+
+	// Publishers on other threads may still be writing to the old buffer, which is read from the next frame on
+	while (m_WritingPublisherCounts[publishBufferIndex] > 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+bool MEngineEventBus::HasDeliveredEvents()
+{
+	for (uint32_t i = 0; i < m_EventTypeCount; ++i)
+	{
+		if (GetDeliveredEventCount(i) > 0)
+			return true;
+	}
+	return false;
+}
+
+// ---------- LOCAL ----------
+
+uint8_t* MEngineEventBus::GetOrCreateChunk(const EventTypeData& eventType, EventBuffer& buffer, uint32_t chunkIndex)
+{
+	uint8_t* chunk = buffer.Chunks[chunkIndex].load(std::memory_order_acquire);
+	if (chunk != nullptr)
+		return chunk;
+
+	// Several publishers may reach a new chunk at once; the first one to install its allocation wins
+	uint8_t* newChunk = static_cast<uint8_t*>(::operator new(static_cast<size_t>(eventType.EventSize) * EVENTS_PER_CHUNK, std::align_val_t(eventType.EventAlignment)));
+	if (buffer.Chunks[chunkIndex].compare_exchange_strong(chunk, newChunk, std::memory_order_acq_rel))
+		return newChunk;
+
+	::operator delete(newChunk, std::align_val_t(eventType.EventAlignment));
+	return chunk;
+}
\ No newline at end of file
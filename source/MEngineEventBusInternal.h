@@ -0,0 +1,10 @@
+#pragma once
+#include "Interface/MEngineEventBus.h"
+
+namespace MEngineEventBus
+{
+	void Initialize();
+	void Shutdown();
+	void SwapBuffers(); // Makes this frame's events the delivered ones and clears the previous frame's; waits for events that are being written to the old buffer
+	bool HasDeliveredEvents(); // True if the next frame has events to deliver
+}
\ No newline at end of file
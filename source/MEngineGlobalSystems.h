@@ -4,13 +4,17 @@
 #include "MEngineComponentManagerInternal.h"
 #include "MEngineConfigInternal.h"
 #include "MEngineConsoleInternal.h"
-#include "MEngineEntityManagerInternal.h"
+#include "MEngineEventBusInternal.h"
 #include "MEngineGraphicsInternal.h"
 #include "MEngineInternalComponentsInternal.h"
 #include "MEngineInputInternal.h"
+#include "MEngineJobsInternal.h"
 #include "MEngineSystemManagerInternal.h"
+#include "MEngineTasksInternal.h"
 #include "MEngineTextInternal.h"
+#include "MEngineTimersInternal.h"
 #include "MEngineUtilityInternal.h"
+#include "MEngineWorldInternal.h"
 
 namespace MEngineGlobalSystems
 {
@@ -18,24 +22,32 @@ namespace MEngineGlobalSystems
 	{
 		MEngineUtility::Initialize(applicationName, initFlags);
 		MEngineConfig::Initialize();
-		MEngineEntityManager::Initialize();
+		MEngineJobs::Initialize();
 		MEngineComponentManager::Initialize();
+		MEngineWorld::Initialize();
 		MEngineInternalComponents::Initialize();
 		MEngineConsole::Initialize();
 		MEngineInput::Initialize();
 		MEngineText::Initialize();
+		MEngineEventBus::Initialize();
+		MEngineTimers::Initialize();
 		MEngineSystemManager::Initialize();
+		MEngineTasks::Initialize();
 	}
 
 	void Stop()
 	{
+		MEngineTasks::Shutdown();
 		MEngineSystemManager::Shutdown();
+		MEngineTimers::Shutdown();
+		MEngineEventBus::Shutdown();
 		MEngineText::Shutdown();
 		MEngineInput::Shutdown();
 		MEngineConsole::shutdown();
 		MEngineInternalComponents::Shutdown();
 		MEngineComponentManager::Shutdown();
-		MEngineEntityManager::Shutdown();
+		MEngineWorld::Shutdown();
+		MEngineJobs::Shutdown();
 		MEngineGraphics::Shutdown(); // TODODB: Place this where it should be after the initialize has been moved in to Start()
 		MEngineConfig::Shutdown();
 		MEngineUtility::Shutdown();
@@ -43,6 +55,7 @@ namespace MEngineGlobalSystems
 
 	void PreEventUpdate()
 	{
+		MEngineWorld::Update(); // World changes only happen on frame boundaries
 		MEngineUtility::Update();
 		MEngineInput::Update();
 	}
@@ -1,12 +1,21 @@
 #include "MEngineGraphicsInternal.h"
 #include "Interface/MengineConfig.h"
 #include "Interface/MEngineComponentManager.h"
+#include "Interface/MEngineConsole.h"
 #include "Interface/MEngineEntityManager.h"
 #include "Interface/MEngineInternalComponents.h"
 #include "Interface/MEngineText.h"
 #include "Interface/MEngineUtility.h"
+#include "Interface/MEngineWorld.h"
+#include "MEngineInputInternal.h"
+#include "MEngineSystemManagerInternal.h"
 #include "MEngineTextInternal.h"
+#include "FrameArena.h"
+#include "FrameCounter.h"
+#include "RadixSort.h"
+#include "SkylinePacker.h"
 #include "sdlLock.h"
+#include "World.h"
 #include <MUtilityIDBank.h>
 #include <MUtilityLocklessQueue.h>
 #include <MUtilityLog.h>
@@ -17,16 +26,26 @@
 #include <SDL_FontCache.h>
 #include <SDL_image.h>
 #include <algorithm>
+#include <atomic>
 #include <mutex>
+#include <sstream>
+#include <string.h>
+#include <type_traits>
 #include <unordered_map>
 
 #define LOG_CATEGORY_GRAPHICS "MEngineGraphics"
+#define MENGINE_GEOMETRY_BATCHING SDL_VERSION_ATLEAST(2, 0, 18) // Rectangles and sprites are batched as vertex colored quads where SDL_RenderGeometry is available
 
 CREATE_NAMESPACED_BITFLAG_OPERATOR_DEFINITIONS(MEngineGraphics, JobTypeMask);
 
 constexpr int32_t CARET_HEIGHT_OFFSET_TOP		= 3;
 constexpr int32_t CARET_HEIGHT_OFFSET_BOTTOM	= 5 + CARET_HEIGHT_OFFSET_TOP;
 constexpr int32_t CARET_END_OF_STRING_OFFSET	= 2;
+constexpr uint32_t RENDER_SNAPSHOT_COUNT		= 3;
+constexpr uint32_t RENDER_SNAPSHOT_NEW_BIT		= 1 << 2; // Set on the ready snapshot index when it has not been taken by the render thread yet
+constexpr int32_t ATLAS_PAGE_SIZE				= 1024;
+constexpr int32_t ATLAS_MAX_ENTRY_SIZE			= 128; // Textures with a larger side get a texture of their own
+constexpr int32_t ATLAS_ENTRY_PADDING			= 1; // Transparent gap between atlas entries so that filtering never samples a neighbour
 
 using namespace MEngine;
 using namespace MEngineGraphics;
@@ -35,13 +54,125 @@ using namespace PredefinedColors;
 
 namespace MEngineGraphics
 {
-	bool IsDeeper(const RenderJob* lhs, const RenderJob* rhs)
+	static_assert(std::is_trivially_destructible<RenderJob>::value, "Render jobs are discarded without being destroyed");
+
+	struct RenderJobList // Reused frame after frame so that copying jobs stops allocating once the buffers have grown large enough
+	{
+		std::vector<RenderJob>	Jobs;
+		FrameArena				Arena; // Holds the job texts
+	};
+
+	struct RetainedRenderList // Render jobs kept between frames; only the jobs of entities reported as changed are rebuilt
+	{
+		std::vector<RenderJob>			Jobs; // In draw order
+		std::vector<int32_t>			JobIndices; // Indexed by entity ID; -1 for entities without a job
+		std::vector<std::vector<char>>	Texts; // Indexed by entity ID; the job text followed by the caret prefix. The inner buffers are moved when the outer vector grows, so the job text pointers stay valid
+		std::vector<EntityID>			DirtyEntities;
+		std::vector<bool>				IsDirty; // Indexed by entity ID
+		std::vector<EntityID>			EntityScratch;
+		std::vector<SortKey>			SortKeys;
+		std::vector<SortKey>			SortKeyScratch;
+		std::vector<RenderJob>			JobScratch;
+		MEngine::WorldID				WorldID; // The world the jobs were built from
+		EntityID						InputTextEntity; // Text input edits the string directly without reporting a change, so the entity being edited is rebuilt every frame
+		const std::string*				InputText				= nullptr;
+		bool							IsSortRequired			= false;
+		bool							IsCompactionRequired	= false;
+
+		uint32_t						LastRebuiltJobCount		= 0;
+		uint64_t						RebuiltJobCount			= 0;
+		uint64_t						SortCount				= 0;
+		uint64_t						FullRebuildCount		= 0;
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+		std::vector<bool>				IsUnreportedChangeLogged; // Indexed by entity ID; keeps each unreported change from being logged every frame
+#endif
+	};
+
+	enum class RenderBatchType
+	{
+		NONE,
+		FILL_RECTS,
+		DRAW_RECTS,
+		TEXTURE,
+		GEOMETRY, // Untextured quads with vertex colors; holds all rectangle draws when geometry batching is used
+	};
+
+	struct AtlasPage // Shared texture that small textures are packed into
+	{
+		AtlasPage(SDL_Texture* texture) : Texture(texture), Packer(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE) {}
+
+		SDL_Texture*	Texture;
+		SkylinePacker	Packer;
+		int32_t			EntryCount = 0;
+	};
+
+	struct RenderBatch // Consecutive draws that share state; submitted as a single call when the state changes
 	{
-		return lhs->Depth > rhs->Depth;
+		RenderBatchType			Type	= RenderBatchType::NONE;
+		ColorData				Color;
+		SDL_Texture*			Texture	= nullptr;
+		std::vector<SDL_Rect>	Rects;
+		std::vector<SDL_Rect>	SourceRects; // Parallel to Rects for texture batches
+#if MENGINE_GEOMETRY_BATCHING
+		std::vector<SDL_Vertex>	Vertices;
+		std::vector<int>		Indices;
+#endif
+		std::vector<SDL_Rect>	DestinationRects; // Scratch buffer for the interpolated rectangles of the jobs at one depth
+
+		uint32_t				DrawCallCount				= 0;
+		uint32_t				BatchedDrawCount			= 0;
+		uint32_t				LastFrameDrawCallCount		= 0;
+		uint32_t				LastFrameBatchedDrawCount	= 0;
 	};
 
-	void CreateRenderJobs();
-	void ExecuteRenderJobs();
+	struct RenderSnapshot
+	{
+		RenderJobList	JobList;
+		uint64_t		SimulationStep		= 0;
+		uint64_t		SimulationStepTime	= 0;
+	};
+
+	struct InterpolationPoint
+	{
+		int32_t		EntityID;
+		SDL_Rect	Rect;
+	};
+
+	bool IsLowerEntityID(const InterpolationPoint& lhs, const InterpolationPoint& rhs)
+	{
+		return lhs.EntityID < rhs.EntityID;
+	};
+
+	void UpdateRenderList();
+	void MarkRenderJobDirty(EntityID ID);
+	void RebuildRenderJob(EntityID ID);
+	bool CreateRenderJob(EntityID ID, RenderJob& outJob, std::vector<char>& outText);
+	uint64_t CalcRenderSortKey(const RenderJob& job);
+	void SortRenderList(RetainedRenderList& renderList);
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	void DetectUnreportedChanges(RetainedRenderList& renderList);
+#endif
+	void SetDrawColor(const ColorData& color, ColorData& inOutCurrentColor);
+	EntityID FindTextEntity(const std::string* text);
+	void CopyRenderJobs(const std::vector<RenderJob>& jobs, RenderJobList& outJobList);
+	void ExecuteRenderJobs(const std::vector<RenderJob>& jobs, const std::vector<InterpolationPoint>* interpolationSource, float interpolationAlpha);
+	void DrawJobText(const RenderJob* job, const SDL_Rect& destinationRect);
+	void DrawJobCaret(const RenderJob* job, const SDL_Rect& destinationRect, ColorData& inOutDrawColor);
+	void BatchFillRect(const SDL_Rect& rect, const ColorData& color, ColorData& inOutDrawColor);
+	void BatchDrawRect(const SDL_Rect& rect, const ColorData& color, ColorData& inOutDrawColor);
+	void BatchTexture(const MEngineTexture& texture, const SDL_Rect& rect, ColorData& inOutDrawColor);
+	void BeginRenderBatch(RenderBatchType type, const ColorData& color, SDL_Texture* texture, ColorData& inOutDrawColor);
+	void FlushRenderBatch(ColorData& inOutDrawColor);
+#if MENGINE_GEOMETRY_BATCHING
+	void AddBatchQuad(const SDL_Rect& rect, const ColorData& color, float textureLeft = 0.0f, float textureTop = 0.0f, float textureRight = 1.0f, float textureBottom = 1.0f);
+#endif
+	TextureID AddSurface(SDL_Surface* surface, bool storeSurfaceInRAM, TextureID reservedTextureID = TextureID::Invalid()); // Takes ownership of the surface
+	TextureID StoreTexture(MEngineTexture* texture, TextureID reservedTextureID);
+	bool PackIntoAtlas(SDL_Surface* surface, int32_t& outPageIndex, SDL_Rect& outSourceRect);
+	void ReleaseAtlasEntry(int32_t pageIndex);
+	void ClearAtlasPageTexture(SDL_Texture* pageTexture);
+	void TakeLatestRenderSnapshot();
+	bool ExecuteRenderStatsCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse);
 
 	SDL_Renderer*	m_Renderer	= nullptr;
 	SDL_Window*		m_Window	= nullptr;
@@ -52,12 +183,23 @@ namespace MEngineGraphics
 	int32_t m_WindowWidth	= -1;
 	int32_t m_WindowHeight	= -1;
 
-	std::vector<RenderJob*>*		m_RenderJobs; // TODODB: Use a frame allocator so that we don't lose performance on all the calls to "new"
+	RetainedRenderList*				m_RenderList;
+	RenderBatch*					m_RenderBatch;
 	std::vector<MEngineTexture*>*	m_Textures;
 	MUtility::MUtilityIDBank<TextureID>*		m_TextureIDBank;
 	std::unordered_map<std::string, TextureID>* m_PathToIDMap;
 	std::mutex m_PathToIDLock;
 	MUtility::LocklessQueue<SurfaceToTextureJob*>* m_SurfaceToTextureQueue;
+	std::vector<AtlasPage*>*	m_AtlasPages;
+	std::mutex					m_AtlasLock;
+
+	// Triple buffer of render snapshots; the back snapshot is only touched by the thread holding the simulation lock and the front snapshot only by the render thread
+	RenderSnapshot*							m_RenderSnapshots;
+	uint32_t								m_BackRenderSnapshot;
+	std::atomic<uint32_t>					m_ReadyRenderSnapshot;
+	uint32_t								m_FrontRenderSnapshot;
+	std::vector<InterpolationPoint>*		m_InterpolationSource; // Entity positions at the simulation step before the one in the front snapshot; sorted by entity ID
+	std::vector<InterpolationPoint>*		m_InterpolationSourceCandidate;
 }
 
 // ---------- INTERFACE ----------
@@ -76,11 +218,12 @@ TextureID MEngine::GetTextureFromPath(const std::string& pathWithExtension)
 		else
 		{
 			std::string absolutePath = MEngine::GetExecutablePath() + "/" + pathWithExtension;
-			SDL_Texture* texture = IMG_LoadTexture(m_Renderer, absolutePath.c_str());
-			if (texture != nullptr)
+			SDL_Surface* surface = IMG_Load(absolutePath.c_str()); // Loaded as a surface so that small images can be packed into an atlas
+			if (surface != nullptr)
 			{
-				returnID = AddTexture(texture);
-				m_PathToIDMap->insert(std::make_pair(pathWithExtension, returnID));
+				returnID = AddSurface(surface, false);
+				if (returnID.IsValid())
+					m_PathToIDMap->insert(std::make_pair(pathWithExtension, returnID));
 			}
 			else
 				MLOG_ERROR("Failed to load texture at path \"" << pathWithExtension << "\"; SDL error = \"" << SDL_GetError() << "\"", LOG_CATEGORY_GRAPHICS);
@@ -104,6 +247,24 @@ void MEngine::UnloadTexture(TextureID textureID)
 	MEngineTexture*& texture = (*m_Textures)[textureID];
 	if (texture != nullptr)
 	{
+		if (!texture->ParentID.IsValid())
+		{
+			// Regions would be left referring to a destroyed texture
+			for (int i = 0; i < m_Textures->size(); ++i)
+			{
+				MEngineTexture*& region = (*m_Textures)[i];
+				if (region != nullptr && region->ParentID == textureID)
+				{
+					delete region;
+					region = nullptr;
+					m_TextureIDBank->ReturnID(TextureID(i));
+				}
+			}
+		}
+
+		if (texture->AtlasPageIndex >= 0)
+			ReleaseAtlasEntry(texture->AtlasPageIndex);
+
 		delete texture;
 		texture = nullptr;
 		m_TextureIDBank->ReturnID(textureID);
@@ -198,6 +359,29 @@ TextureID MEngine::CreateTextureFromTextureData(const TextureData& textureData,
 	return reservedID;
 }
 
+TextureID MEngine::CreateTextureRegion(TextureID parentTextureID, int32_t posX, int32_t posY, int32_t width, int32_t height)
+{
+	HandleSurfaceToTextureConversions();
+
+	if (!parentTextureID.IsValid() || parentTextureID >= static_cast<int64_t>(m_Textures->size()) || (*m_Textures)[parentTextureID] == nullptr)
+	{
+		MLOG_WARNING("Attempted to create texture region from invalid texture ID; ID = " << parentTextureID, LOG_CATEGORY_GRAPHICS);
+		return TextureID::Invalid();
+	}
+
+	const MEngineTexture& parent = *(*m_Textures)[parentTextureID];
+	if (posX < 0 || posY < 0 || width <= 0 || height <= 0 || posX + width > parent.Width || posY + height > parent.Height)
+	{
+		MLOG_WARNING("Invalid region supplied [" << parent.Width << ',' << parent.Height << ']' << " (" << posX << ',' << posY << ") (" << (posX + width) << ',' << (posY + height) << ')', LOG_CATEGORY_GRAPHICS);
+		return TextureID::Invalid();
+	}
+
+	// Regions of regions are flattened so that every region refers directly to a texture that owns its pixels
+	const TextureID rootID		= parent.ParentID.IsValid() ? parent.ParentID : parentTextureID;
+	const SDL_Rect sourceRect	= { parent.SourceRect.x + posX, parent.SourceRect.y + posY, width, height };
+	return StoreTexture(new MEngineTexture(parent, rootID, sourceRect), TextureID::Invalid());
+}
+
 const TextureData MEngine::GetTextureData(TextureID textureID)
 {
 	HandleSurfaceToTextureConversions();
@@ -295,12 +479,20 @@ bool MEngine::IsTextureIDValid(TextureID ID)
 
 bool MEngineGraphics::Initialize(const char* appName, int32_t windowPosX, int32_t windowPosY, int32_t windowWidth, int32_t windowHeight)
 {
-	m_RenderJobs			= new std::vector<RenderJob*>();
+	m_RenderList			= new RetainedRenderList();
+	m_RenderBatch			= new RenderBatch();
 	m_Textures				= new std::vector<MEngineTexture*>();
 	m_TextureIDBank			= new MUtility::MUtilityIDBank<TextureID>();
 	m_PathToIDMap			= new std::unordered_map<std::string, TextureID>();
 	m_SurfaceToTextureQueue = new MUtility::LocklessQueue<SurfaceToTextureJob*>();
+	m_AtlasPages			= new std::vector<AtlasPage*>();
 	m_DispayBounds			= new std::vector<SDL_Rect>();
+	m_RenderSnapshots				= new RenderSnapshot[RENDER_SNAPSHOT_COUNT];
+	m_BackRenderSnapshot			= 0;
+	m_ReadyRenderSnapshot			= 1;
+	m_FrontRenderSnapshot			= 2;
+	m_InterpolationSource			= new std::vector<InterpolationPoint>();
+	m_InterpolationSourceCandidate	= new std::vector<InterpolationPoint>();
 
 	m_DisplayCount = SDL_GetNumVideoDisplays();
 	for (int i = 0; i < m_DisplayCount; ++i)
@@ -310,7 +502,8 @@ bool MEngineGraphics::Initialize(const char* appName, int32_t windowPosX, int32_
 	}
 
 	const MEngine::InitFlags initFlags = GetInitFlags();
-	int32_t initialWindowPosX, initialWindowPosY;
+	int32_t initialWindowPosX = windowPosX;
+	int32_t initialWindowPosY = windowPosY;
 	if ((initFlags & InitFlags::StartWindowCentered) != 0)
 	{
 		initialWindowPosX = GetDisplayWidth(0) / 2 - windowWidth / 2;
@@ -341,18 +534,24 @@ bool MEngineGraphics::Initialize(const char* appName, int32_t windowPosX, int32_
 	SDL_RendererInfo renderInfo;
 	SDL_GetRendererInfo(m_Renderer, &renderInfo);
 	MLOG_INFO("Graphics initialized using " << renderInfo.name << " renderer", LOG_CATEGORY_GRAPHICS);
+
+	RegisterGlobalCommand("renderstats", MEngineConsoleCallback(ExecuteRenderStatsCommand), "Prints the size of the render list, how many of its jobs have been rebuilt, how well the last frame's draws were batched and how many texture atlas pages are in use");
 	return true;
 }
 
 void MEngineGraphics::Shutdown()
 {
+	if (m_RenderList == nullptr) // Graphics are only initialized when a window is created
+		return;
+
 	if ((GetInitFlags() & InitFlags::RememberWindowPosition) != 0)
 	{
 		Config::SetInt("WindowPosX", GetWindowPosX());
 		Config::SetInt("WindowPosY", GetWindowPosY());
 	}
 
-	delete m_RenderJobs;
+	delete m_RenderList;
+	delete m_RenderBatch;
 
 	for (int i = 0; i < m_Textures->size(); ++i)
 	{
@@ -360,19 +559,27 @@ void MEngineGraphics::Shutdown()
 	}
 	delete m_Textures;
 
+	for (int i = 0; i < m_AtlasPages->size(); ++i)
+	{
+		SDL_DestroyTexture((*m_AtlasPages)[i]->Texture);
+		delete (*m_AtlasPages)[i];
+	}
+	delete m_AtlasPages;
+
 	delete m_TextureIDBank;
 	delete m_PathToIDMap;
 	delete m_SurfaceToTextureQueue;
 	delete m_DispayBounds;
+	m_RenderList = nullptr;
+
+	delete[] m_RenderSnapshots;
+	delete m_InterpolationSource;
+	delete m_InterpolationSourceCandidate;
 }
 
 TextureID MEngineGraphics::AddTexture(SDL_Texture* sdlTexture, SDL_Surface* optionalSurfaceCopy, TextureID reservedTextureID)
 {
-	MEngineTexture* texture = new MEngineTexture(sdlTexture, optionalSurfaceCopy);
-
-	TextureID ID = reservedTextureID.IsValid() ? reservedTextureID : GetNextTextureID();
-	ID >= static_cast<int64_t>(m_Textures->size()) ? m_Textures->push_back(texture) : (*m_Textures)[ID] = texture;
-	return ID;
+	return StoreTexture(new MEngineTexture(sdlTexture, optionalSurfaceCopy), reservedTextureID);
 }
 
 void MEngineGraphics::HandleSurfaceToTextureConversions()
@@ -380,22 +587,7 @@ void MEngineGraphics::HandleSurfaceToTextureConversions()
 	SurfaceToTextureJob* job;
 	while (m_SurfaceToTextureQueue->Consume(job))
 	{
-		SdlApiLock.lock();
-		SDL_Texture* texture = SDL_CreateTextureFromSurface(m_Renderer, job->Surface );
-		SdlApiLock.unlock();
-		if (texture != nullptr)
-		{
-			MEngineGraphics::AddTexture(texture, (job->StoreSurfaceInRAM ? job->Surface : nullptr), job->ReservedID);
-		}
-		else
-		{
-			MLOG_ERROR("Failed to create texture from surface", LOG_CATEGORY_GRAPHICS);
-			SDL_FreeSurface(job->Surface);
-			continue;
-		}
-
-		if (!job->StoreSurfaceInRAM)
-			SDL_FreeSurface(job->Surface);
+		AddSurface(job->Surface, job->StoreSurfaceInRAM, job->ReservedID);
 		delete job;
 	}
 }
@@ -417,242 +609,872 @@ SDL_Window* MEngineGraphics::GetWindow()
 
 void MEngineGraphics::Render()
 {
+	if (m_Renderer == nullptr) // Headless or no window created
+		return;
+
 	HandleSurfaceToTextureConversions();
 
 	SdlApiLock.lock();
 	SDL_RenderClear(m_Renderer);
-	CreateRenderJobs();
-	ExecuteRenderJobs();
+	if (MEngineSystemManager::IsSimulationThreadRunning())
+	{
+		TakeLatestRenderSnapshot();
+		const RenderSnapshot& snapshot = m_RenderSnapshots[m_FrontRenderSnapshot];
+		float timeSinceStep = static_cast<float>((SDL_GetPerformanceCounter() - snapshot.SimulationStepTime) / static_cast<double>(SDL_GetPerformanceFrequency()));
+		float interpolationAlpha = std::min(timeSinceStep / MEngineSystemManager::GetSimulationSpeed(), 1.0f);
+		ExecuteRenderJobs(snapshot.JobList.Jobs, m_InterpolationSource, interpolationAlpha);
+	}
+	else
+	{
+		UpdateRenderList();
+		ExecuteRenderJobs(m_RenderList->Jobs, nullptr, 0.0f);
+	}
+	MEngineSystemManager::GetPresentationFrameCounter().BeginPresentWait();
 	SDL_RenderPresent(m_Renderer);
+	MEngineSystemManager::GetPresentationFrameCounter().EndPresentWait();
 	SdlApiLock.unlock();
 }
 
+void MEngineGraphics::PublishRenderSnapshot()
+{
+	if (m_Renderer == nullptr)
+		return;
+
+	UpdateRenderList();
+	RenderSnapshot& snapshot = m_RenderSnapshots[m_BackRenderSnapshot];
+	CopyRenderJobs(m_RenderList->Jobs, snapshot.JobList); // The render thread draws the snapshot while the simulation keeps changing the render list
+	snapshot.SimulationStep		= MEngineSystemManager::GetSimulationStepCount();
+	snapshot.SimulationStepTime	= MEngineSystemManager::GetLastSimulationStepTime();
+
+	m_BackRenderSnapshot = m_ReadyRenderSnapshot.exchange(m_BackRenderSnapshot | RENDER_SNAPSHOT_NEW_BIT) & ~RENDER_SNAPSHOT_NEW_BIT;
+}
+
+void MEngineGraphics::HandleComponentEvents(const std::vector<ComponentEvent>& events)
+{
+	if (m_RenderList == nullptr)
+		return;
+
+	for (int i = 0; i < events.size(); ++i)
+	{
+		if ((events[i].ComponentTypes & RENDERED_COMPONENT_TYPES) != 0)
+			MarkRenderJobDirty(events[i].ID);
+	}
+}
+
 // ---------- LOCAL ----------
 
-void MEngineGraphics::CreateRenderJobs()
+void MEngineGraphics::UpdateRenderList()
 {
-	std::vector<EntityID> entities;
-	ComponentMask compareMask = PosSizeComponent::GetComponentMask() | RectangleRenderingComponent::GetComponentMask() | TextureRenderingComponent::GetComponentMask();
-	GetEntitiesMatchingMask(compareMask, entities, MaskMatchMode::Any);
+	MEngineSystemManager::CollectComponentEvents(); // Lets changes made earlier in the frame be drawn this frame
 
-	for (int i = 0; i < entities.size(); ++i)
+	RetainedRenderList& renderList = *m_RenderList;
+	if (GetActiveWorld() != renderList.WorldID)
 	{
-		RenderJob* job = new RenderJob();
-		ComponentMask entityComponentMask = GetComponentMask(entities[i]);
-		const PosSizeComponent* posSizeComp = static_cast<const PosSizeComponent*>(GetComponent(entities[i], PosSizeComponent::GetComponentMask()));
-		if ((entityComponentMask & PosSizeComponent::GetComponentMask()) != 0)
+		renderList.Jobs.clear();
+		std::fill(renderList.JobIndices.begin(), renderList.JobIndices.end(), -1);
+		renderList.WorldID = GetActiveWorld();
+		renderList.InputTextEntity.Invalidate();
+		renderList.InputText = nullptr;
+		++renderList.FullRebuildCount;
+
+		renderList.EntityScratch.clear();
+		GetEntitiesMatchingMask(POS_SIZE_COMPONENT_MASK | RECTANGLE_RENDERING_COMPONENT_MASK | TEXTURE_RENDERING_COMPONENT_MASK, renderList.EntityScratch, MaskMatchMode::Any);
+		for (int i = 0; i < renderList.EntityScratch.size(); ++i)
 		{
-			job->DestinationRect = { posSizeComp->PosX, posSizeComp->PosY, posSizeComp->Width, posSizeComp->Height };
-			job->Depth = posSizeComp->PosZ;
+			MarkRenderJobDirty(renderList.EntityScratch[i]);
 		}
-		else
+	}
+
+	const std::string* inputText = MEngineInput::GetTextInputString();
+	if (inputText != renderList.InputText)
+	{
+		if (renderList.InputTextEntity.IsValid()) // Removes the caret
+			MarkRenderJobDirty(renderList.InputTextEntity);
+
+		renderList.InputTextEntity = FindTextEntity(inputText);
+		renderList.InputText = inputText;
+	}
+
+	if (renderList.InputTextEntity.IsValid())
+		MarkRenderJobDirty(renderList.InputTextEntity);
+
+	renderList.LastRebuiltJobCount = static_cast<uint32_t>(renderList.DirtyEntities.size());
+	renderList.RebuiltJobCount += renderList.DirtyEntities.size();
+	for (int i = 0; i < renderList.DirtyEntities.size(); ++i)
+	{
+		renderList.IsDirty[renderList.DirtyEntities[i]] = false;
+		RebuildRenderJob(renderList.DirtyEntities[i]);
+	}
+	renderList.DirtyEntities.clear();
+
+	if (renderList.IsCompactionRequired)
+	{
+		renderList.Jobs.erase(std::remove_if(renderList.Jobs.begin(), renderList.Jobs.end(), [](const RenderJob& job) { return job.JobMask == JobTypeMask::INVALID; }), renderList.Jobs.end());
+	}
+
+	if (renderList.IsSortRequired)
+	{
+		SortRenderList(renderList);
+		++renderList.SortCount;
+	}
+
+	if (renderList.IsCompactionRequired || renderList.IsSortRequired)
+	{
+		for (int i = 0; i < renderList.Jobs.size(); ++i)
+		{
+			renderList.JobIndices[renderList.Jobs[i].EntityID] = i;
+		}
+		renderList.IsCompactionRequired	= false;
+		renderList.IsSortRequired		= false;
+	}
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	DetectUnreportedChanges(renderList);
+#endif
+}
+
+void MEngineGraphics::MarkRenderJobDirty(EntityID ID)
+{
+	RetainedRenderList& renderList = *m_RenderList;
+	if (ID >= renderList.IsDirty.size())
+	{
+		renderList.JobIndices.resize(ID + 1, -1);
+		renderList.Texts.resize(ID + 1);
+		renderList.IsDirty.resize(ID + 1, false);
+	}
+
+	if (!renderList.IsDirty[ID])
+	{
+		renderList.IsDirty[ID] = true;
+		renderList.DirtyEntities.push_back(ID);
+	}
+}
+
+void MEngineGraphics::RebuildRenderJob(EntityID ID)
+{
+	RetainedRenderList& renderList = *m_RenderList;
+	int32_t jobIndex = renderList.JobIndices[ID];
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (ID < renderList.IsUnreportedChangeLogged.size())
+		renderList.IsUnreportedChangeLogged[ID] = false;
+#endif
+
+	RenderJob job;
+	if (!IsEntityIDValid(ID) || !CreateRenderJob(ID, job, renderList.Texts[ID]))
+	{
+		if (jobIndex >= 0) // Removed jobs are invalidated here and erased once all dirty jobs have been rebuilt
 		{
-			MLOG_WARNING("Found entity with a renderable component that lacks position data; entityID = " << entities[i], LOG_CATEGORY_GRAPHICS);
-			delete job;
+			renderList.Jobs[jobIndex].JobMask = JobTypeMask::INVALID;
+			renderList.JobIndices[ID] = -1;
+			renderList.IsCompactionRequired = true;
+		}
+		return;
+	}
+
+	if (jobIndex >= 0)
+	{
+		if (renderList.Jobs[jobIndex].SortKey != job.SortKey)
+			renderList.IsSortRequired = true;
+
+		renderList.Jobs[jobIndex] = job;
+	}
+	else
+	{
+		renderList.JobIndices[ID] = static_cast<int32_t>(renderList.Jobs.size());
+		renderList.Jobs.push_back(job);
+		renderList.IsSortRequired = true;
+	}
+}
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+void MEngineGraphics::DetectUnreportedChanges(RetainedRenderList& renderList)
+{
+	// Component data edited in place without NotifyComponentsChanged never reaches the render list; compares the cached jobs against the components to point such edits out
+	for (int i = 0; i < renderList.Jobs.size(); ++i)
+	{
+		const RenderJob& job = renderList.Jobs[i];
+		if (!IsEntityIDValid(job.EntityID))
 			continue;
+
+		const ComponentMask entityComponentMask = GetComponentMask(job.EntityID);
+		bool isUnreported = false;
+		if ((entityComponentMask & POS_SIZE_COMPONENT_MASK) != 0)
+		{
+			const PosSizeComponent* posSizeComp = GetComponent<PosSizeComponent>(job.EntityID);
+			isUnreported = job.DestinationRect.x != posSizeComp->PosX || job.DestinationRect.y != posSizeComp->PosY || job.DestinationRect.w != posSizeComp->Width ||
+				job.DestinationRect.h != posSizeComp->Height || job.Depth != posSizeComp->PosZ;
 		}
 
-		if ((entityComponentMask & RectangleRenderingComponent::GetComponentMask()) != 0)
+		if (!isUnreported && (job.JobMask & JobTypeMask::TEXT) != 0 && (entityComponentMask & TEXT_COMPONENT_MASK) != 0)
 		{
-			const RectangleRenderingComponent* rectComp = static_cast<const RectangleRenderingComponent*>(GetComponent(entities[i], RectangleRenderingComponent::GetComponentMask()));
-			if (!rectComp->RenderIgnore && !rectComp->IsFullyTransparent())
-			{
-				if (!rectComp->BorderColor.IsFullyTransparent())
-					job->BorderColor = rectComp->BorderColor;
+			const TextComponent* textComp = GetComponent<TextComponent>(job.EntityID);
+			isUnreported = textComp->Text != nullptr && strcmp(job.Text, textComp->Text->c_str()) != 0;
+		}
 
-				if (!rectComp->FillColor.IsFullyTransparent())
-					job->FillColor = rectComp->FillColor;
+		if (!isUnreported)
+			continue;
 
-				job->JobMask |= JobTypeMask::RECTANGLE;
-			}
+		if (job.EntityID >= renderList.IsUnreportedChangeLogged.size())
+			renderList.IsUnreportedChangeLogged.resize(job.EntityID + 1, false);
+
+		if (!renderList.IsUnreportedChangeLogged[job.EntityID])
+		{
+			MLOG_WARNING("Rendered components of entity " << job.EntityID << " were changed without calling NotifyComponentsChanged; the change will not be drawn", LOG_CATEGORY_GRAPHICS);
+			renderList.IsUnreportedChangeLogged[job.EntityID] = true;
 		}
+	}
+}
+#endif
 
-		if ((entityComponentMask & TextureRenderingComponent::GetComponentMask()) != 0)
+bool MEngineGraphics::CreateRenderJob(EntityID ID, RenderJob& outJob, std::vector<char>& outText)
+{
+	ComponentMask entityComponentMask = GetComponentMask(ID);
+	if ((entityComponentMask & (POS_SIZE_COMPONENT_MASK | RECTANGLE_RENDERING_COMPONENT_MASK | TEXTURE_RENDERING_COMPONENT_MASK)) == 0)
+		return false;
+
+	RenderJob* job = &outJob;
+	job->EntityID = ID;
+	const PosSizeComponent* posSizeComp = GetComponent<PosSizeComponent>(ID);
+	if ((entityComponentMask & POS_SIZE_COMPONENT_MASK) != 0)
+	{
+		job->DestinationRect = { posSizeComp->PosX, posSizeComp->PosY, posSizeComp->Width, posSizeComp->Height };
+		job->Depth = posSizeComp->PosZ;
+	}
+	else
+	{
+		MLOG_WARNING("Found entity with a renderable component that lacks position data; entityID = " << ID, LOG_CATEGORY_GRAPHICS);
+		return false;
+	}
+
+	if ((entityComponentMask & RECTANGLE_RENDERING_COMPONENT_MASK) != 0)
+	{
+		const RectangleRenderingComponent* rectComp = GetComponent<RectangleRenderingComponent>(ID);
+		if (!rectComp->RenderIgnore && !rectComp->IsFullyTransparent())
 		{
-			const TextureRenderingComponent* textureComp = static_cast<const TextureRenderingComponent*>(GetComponent(entities[i], TextureRenderingComponent::GetComponentMask()));
-			if (!textureComp->RenderIgnore && textureComp->TextureID.IsValid())
-			{
-				job->TextureID = textureComp->TextureID;
-				job->JobMask |= JobTypeMask::TEXTURE;
-			}
+			if (!rectComp->BorderColor.IsFullyTransparent())
+				job->BorderColor = rectComp->BorderColor;
+
+			if (!rectComp->FillColor.IsFullyTransparent())
+				job->FillColor = rectComp->FillColor;
+
+			job->JobMask |= JobTypeMask::RECTANGLE;
+		}
+	}
+
+	if ((entityComponentMask & TEXTURE_RENDERING_COMPONENT_MASK) != 0)
+	{
+		const TextureRenderingComponent* textureComp = GetComponent<TextureRenderingComponent>(ID);
+		if (!textureComp->RenderIgnore && textureComp->TextureID.IsValid())
+		{
+			job->TextureID = textureComp->TextureID;
+			job->JobMask |= JobTypeMask::TEXTURE;
 		}
+	}
 
-		if ((entityComponentMask & TextComponent::GetComponentMask()) != 0)
+	outText.clear();
+	if ((entityComponentMask & TEXT_COMPONENT_MASK) != 0)
+	{
+		const TextComponent* textComp = GetComponent<TextComponent>(ID);
+		if (!textComp->RenderIgnore && textComp->FontID.IsValid() && textComp->Text != nullptr)
 		{
-			const TextComponent* textComp = static_cast<const TextComponent*>(GetComponent(entities[i], TextComponent::GetComponentMask()));
-			if (!textComp->RenderIgnore && textComp->FontID.IsValid() && textComp->Text != nullptr)
+			const char* text = textComp->Text->c_str();
+			if (*textComp->Text != "")
 			{
-				if (*textComp->Text != "")
-				{
+				job->FontID = textComp->FontID;
+				outText.insert(outText.end(), text, text + textComp->Text->size() + 1);
+				job->TextRenderMode = ((posSizeComp->Width > 0 && posSizeComp->Height > 0) ? TextRenderMode::BOX : TextRenderMode::PLAIN);
+				job->TextAlignment = textComp->Alignment;
+				job->ScrolledLinesCount = textComp->ScrolledLinesCount;
+				job->JobMask |= JobTypeMask::TEXT;
+			}
+
+			// Caret
+			if (IsInputString(textComp->Text))
+			{
+				if ((job->JobMask & JobTypeMask::TEXT) == 0)
 					job->FontID = textComp->FontID;
-					job->CopyText(textComp->Text->c_str());
-					job->TextRenderMode = ((posSizeComp->Width > 0 && posSizeComp->Height > 0) ? TextRenderMode::BOX : TextRenderMode::PLAIN);
-					job->TextRect = job->DestinationRect;
-
-					int32_t textHeight = GetTextHeight(textComp->FontID, job->Text);
-
-					// Horizontal alignment
-					switch (textComp->Alignment)
-					{
-						case TextAlignment::TopLeft:
-						case TextAlignment::CenterLeft:
-						case TextAlignment::BottomLeft:
-						{
-							job->HorizontalTextAlignment = FC_ALIGN_LEFT;
-						} break;
-	
-						case TextAlignment::TopCentered:
-						case TextAlignment::CenterCentered:
-						case TextAlignment::BottomCentered:
-						{
-							job->HorizontalTextAlignment = FC_ALIGN_CENTER;
-						} break;
-	
-						case TextAlignment::TopRight:
-						case TextAlignment::CenterRight:
-						case TextAlignment::BottomRight:
-						{
-							job->HorizontalTextAlignment = FC_ALIGN_RIGHT;
-						} break;
-	
-						default:
-							break;
-					}
-
-					// Vertical alignment
-					switch (textComp->Alignment)
-					{
-						case TextAlignment::CenterLeft:
-						case TextAlignment::CenterCentered:
-						case TextAlignment::CenterRight:
-						{
-							job->TextRect.y += (job->DestinationRect.h / 2) - (textHeight / 2);
-						} break;
-
-						case TextAlignment::BottomLeft:
-						case TextAlignment::BottomCentered:
-						case TextAlignment::BottomRight:
-						{
-							job->TextRect.y += job->DestinationRect.h - textHeight;
-						} break;
-
-						case TextAlignment::TopLeft:
-						case TextAlignment::TopCentered:
-						case TextAlignment::TopRight:
-						default:
-							break;
-					}
-
-					job->JobMask |= JobTypeMask::TEXT;
-				}
 
-				// Scroll
-				if (textComp->ScrolledLinesCount > 0)
-				{
-					uint32_t scrollHeight = GetLineHeight(textComp->FontID) * textComp->ScrolledLinesCount;
-					job->TextRect.y -= scrollHeight;
-					job->TextRect.h += scrollHeight;
-				}
+				const size_t caretIndex = std::min(static_cast<size_t>(GetTextInputCaretIndex()), textComp->Text->size());
+				outText.insert(outText.end(), text, text + caretIndex);
+				outText.push_back('\0');
+				job->CaretIsAtEnd = caretIndex >= textComp->Text->size();
 
-				// Caret
-				if (IsInputString(textComp->Text))
-				{
-					if ((job->JobMask & JobTypeMask::TEXT) == 0)
-						job->FontID = textComp->FontID;
+				job->JobMask |= JobTypeMask::CARET;
+			}
 
-					// Add caret drawing data
-					const uint64_t caretIndex = GetTextInputCaretIndex();
+			// The buffer may have moved while it was filled
+			if ((job->JobMask & JobTypeMask::TEXT) != 0)
+				job->Text = outText.data();
+
+			if ((job->JobMask & JobTypeMask::CARET) != 0)
+				job->CaretPrefixText = outText.data() + ((job->JobMask & JobTypeMask::TEXT) != 0 ? textComp->Text->size() + 1 : 0);
+		}
+	}
 
-					// TODODB: Put char* substr logic into MUtility
-					char* substr = static_cast<char*>(malloc(caretIndex + 1));
-					memcpy(substr, textComp->Text->c_str(), caretIndex);
-					substr[caretIndex] = '\0';
+	job->SortKey = CalcRenderSortKey(*job);
+	return job->JobMask != JobTypeMask::INVALID;
+}
 
-					job->CaretOffsetX = GetTextWidth(textComp->FontID, substr);
-					free(substr);
+uint64_t MEngineGraphics::CalcRenderSortKey(const RenderJob& job)
+{
+	// Deeper jobs are drawn first. The draw order within a depth is undefined, so jobs sharing texture, font and fill color are placed next to each other there
+	// Texture IDs are handed out in load order and atlas pages are filled in load order, so ordering by ID also keeps most jobs on the same atlas page together
+	uint64_t textureBits	= (job.JobMask & JobTypeMask::TEXTURE) != 0 ? static_cast<uint16_t>(job.TextureID + 1) : 0;
+	uint64_t fontBits		= (job.JobMask & (JobTypeMask::TEXT | JobTypeMask::CARET)) != 0 ? static_cast<uint8_t>(job.FontID + 1) : 0;
+	uint64_t colorBits		= 0;
+	if ((job.JobMask & JobTypeMask::RECTANGLE) != 0 && !job.FillColor.IsFullyTransparent())
+		colorBits = (job.FillColor.R & 0xE0) | ((job.FillColor.G & 0xE0) >> 3) | (job.FillColor.B >> 6); // RGB 3-3-2; colors that collide only group less well
+
+	return (static_cast<uint64_t>(UINT32_MAX - job.Depth) << 32) | (textureBits << 16) | (fontBits << 8) | colorBits;
+}
 
-					if (caretIndex >= strlen(textComp->Text->c_str()))
-						job->CaretOffsetX += CARET_END_OF_STRING_OFFSET;
+void MEngineGraphics::SortRenderList(RetainedRenderList& renderList)
+{
+	std::vector<SortKey>& keys = renderList.SortKeys;
+	keys.resize(renderList.Jobs.size());
+	for (int i = 0; i < renderList.Jobs.size(); ++i)
+	{
+		keys[i] = { renderList.Jobs[i].SortKey, static_cast<uint32_t>(i) };
+	}
+	RadixSort(keys, renderList.SortKeyScratch); // Stable, so jobs with equal keys keep their order from the last sort
 
-					job->JobMask |= JobTypeMask::CARET;
+	renderList.JobScratch.resize(keys.size());
+	for (int i = 0; i < keys.size(); ++i)
+	{
+		renderList.JobScratch[i] = renderList.Jobs[keys[i].Index];
+	}
+	renderList.Jobs.swap(renderList.JobScratch);
+}
+
+EntityID MEngineGraphics::FindTextEntity(const std::string* text)
+{
+	if (text == nullptr)
+		return EntityID::Invalid();
+
+	std::vector<EntityID>& entities = m_RenderList->EntityScratch;
+	entities.clear();
+	GetEntitiesMatchingMask(TEXT_COMPONENT_MASK, entities, MaskMatchMode::Partial);
+	for (int i = 0; i < entities.size(); ++i)
+	{
+		if (GetComponent<TextComponent>(entities[i])->Text == text)
+			return entities[i];
+	}
+	return EntityID::Invalid();
+}
+
+void MEngineGraphics::CopyRenderJobs(const std::vector<RenderJob>& jobs, RenderJobList& outJobList)
+{
+	outJobList.Jobs.assign(jobs.begin(), jobs.end());
+	outJobList.Arena.Reset();
+	for (int i = 0; i < outJobList.Jobs.size(); ++i)
+	{
+		RenderJob& job = outJobList.Jobs[i];
+		if (job.Text != nullptr)
+			job.Text = outJobList.Arena.CopyText(job.Text, strlen(job.Text));
+
+		if (job.CaretPrefixText != nullptr)
+			job.CaretPrefixText = outJobList.Arena.CopyText(job.CaretPrefixText, strlen(job.CaretPrefixText));
+	}
+}
+
+void MEngineGraphics::ExecuteRenderJobs(const std::vector<RenderJob>& jobs, const std::vector<InterpolationPoint>* interpolationSource, float interpolationAlpha)
+{
+	// Store the draw color used before
+	uint8_t startingDrawColor[4];
+	SDL_GetRenderDrawColor(m_Renderer, &startingDrawColor[0], &startingDrawColor[1], &startingDrawColor[2], &startingDrawColor[3]);
+	ColorData drawColor = ColorData(startingDrawColor[0], startingDrawColor[1], startingDrawColor[2], startingDrawColor[3]);
+
+	RenderBatch& batch = *m_RenderBatch;
+	batch.DrawCallCount			= 0;
+	batch.BatchedDrawCount		= 0;
+	std::vector<SDL_Rect>& destinationRects = batch.DestinationRects;
+
+	// Jobs at the same depth have no defined order between them, so each kind of draw is done for all jobs of a depth before the next kind; this lets consecutive draws be merged into one call
+	int runStart = 0;
+	while (runStart < jobs.size())
+	{
+		int runEnd = runStart + 1;
+		while (runEnd < jobs.size() && jobs[runEnd].Depth == jobs[runStart].Depth)
+		{
+			++runEnd;
+		}
+
+		destinationRects.clear();
+		for (int i = runStart; i < runEnd; ++i)
+		{
+			const RenderJob* job = &jobs[i]; // Guaranteed to have position data
+			SDL_Rect destinationRect = job->DestinationRect;
+			if (interpolationSource != nullptr)
+			{
+				const InterpolationPoint key = { job->EntityID, {} };
+				auto iterator = std::lower_bound(interpolationSource->begin(), interpolationSource->end(), key, IsLowerEntityID);
+				if (iterator != interpolationSource->end() && iterator->EntityID == key.EntityID)
+				{
+					destinationRect.x = iterator->Rect.x + static_cast<int32_t>((job->DestinationRect.x - iterator->Rect.x) * interpolationAlpha);
+					destinationRect.y = iterator->Rect.y + static_cast<int32_t>((job->DestinationRect.y - iterator->Rect.y) * interpolationAlpha);
 				}
 			}
+			destinationRects.push_back(destinationRect);
 		}
 
-		if (job->JobMask != JobTypeMask::INVALID)
+		for (int i = runStart; i < runEnd; ++i)
 		{
-			m_RenderJobs->push_back(job);
+			if ((jobs[i].JobMask & JobTypeMask::RECTANGLE) != 0 && !jobs[i].FillColor.IsFullyTransparent())
+				BatchFillRect(destinationRects[i - runStart], jobs[i].FillColor, drawColor);
 		}
-		else
-			delete job;
+
+		for (int i = runStart; i < runEnd; ++i)
+		{
+			if ((jobs[i].JobMask & JobTypeMask::RECTANGLE) != 0 && !jobs[i].BorderColor.IsFullyTransparent())
+				BatchDrawRect(destinationRects[i - runStart], jobs[i].BorderColor, drawColor);
+		}
+
+		for (int i = runStart; i < runEnd; ++i)
+		{
+			if ((jobs[i].JobMask & JobTypeMask::TEXTURE) != 0 && (*m_Textures)[jobs[i].TextureID] != nullptr) // Snapshots may outlive their textures
+				BatchTexture(*(*m_Textures)[jobs[i].TextureID], destinationRects[i - runStart], drawColor);
+		}
+		FlushRenderBatch(drawColor);
+
+		for (int i = runStart; i < runEnd; ++i)
+		{
+			if ((jobs[i].JobMask & JobTypeMask::TEXT) != 0)
+				DrawJobText(&jobs[i], destinationRects[i - runStart]);
+
+			if ((jobs[i].JobMask & JobTypeMask::CARET) != 0)
+				DrawJobCaret(&jobs[i], destinationRects[i - runStart], drawColor);
+		}
+
+		runStart = runEnd;
 	}
-	std::sort(m_RenderJobs->begin(), m_RenderJobs->end(), IsDeeper);
+
+	batch.LastFrameDrawCallCount	= batch.DrawCallCount;
+	batch.LastFrameBatchedDrawCount	= batch.BatchedDrawCount;
+
+	// Restore draw color
+	SDL_SetRenderDrawColor(m_Renderer, startingDrawColor[0], startingDrawColor[1], startingDrawColor[2], startingDrawColor[3]);
 }
 
-void MEngineGraphics::ExecuteRenderJobs()
+void MEngineGraphics::DrawJobText(const RenderJob* job, const SDL_Rect& destinationRect)
 {
-	// Store the draw color used before
-	uint8_t startingDrawColor[4];
-	SDL_GetRenderDrawColor(m_Renderer, &startingDrawColor[0], &startingDrawColor[1], &startingDrawColor[2], &startingDrawColor[3]);
+	SDL_Rect textRect = destinationRect;
+	FC_AlignEnum horizontalTextAlignment = FC_ALIGN_LEFT;
+	int32_t textHeight = GetTextHeight(job->FontID, job->Text);
+
+	// Horizontal alignment
+	switch (job->TextAlignment)
+	{
+		case TextAlignment::TopLeft:
+		case TextAlignment::CenterLeft:
+		case TextAlignment::BottomLeft:
+		{
+			horizontalTextAlignment = FC_ALIGN_LEFT;
+		} break;
+
+		case TextAlignment::TopCentered:
+		case TextAlignment::CenterCentered:
+		case TextAlignment::BottomCentered:
+		{
+			horizontalTextAlignment = FC_ALIGN_CENTER;
+		} break;
+
+		case TextAlignment::TopRight:
+		case TextAlignment::CenterRight:
+		case TextAlignment::BottomRight:
+		{
+			horizontalTextAlignment = FC_ALIGN_RIGHT;
+		} break;
+
+		default:
+			break;
+	}
+
+	// Vertical alignment
+	switch (job->TextAlignment)
+	{
+		case TextAlignment::CenterLeft:
+		case TextAlignment::CenterCentered:
+		case TextAlignment::CenterRight:
+		{
+			textRect.y += (destinationRect.h / 2) - (textHeight / 2);
+		} break;
+
+		case TextAlignment::BottomLeft:
+		case TextAlignment::BottomCentered:
+		case TextAlignment::BottomRight:
+		{
+			textRect.y += destinationRect.h - textHeight;
+		} break;
+
+		case TextAlignment::TopLeft:
+		case TextAlignment::TopCentered:
+		case TextAlignment::TopRight:
+		default:
+			break;
+	}
+
+	// Scroll
+	if (job->ScrolledLinesCount > 0)
+	{
+		uint32_t scrollHeight = GetLineHeight(job->FontID) * job->ScrolledLinesCount;
+		textRect.y -= scrollHeight;
+		textRect.h += scrollHeight;
+	}
+
+	switch (job->TextRenderMode)
+	{
+		case TextRenderMode::PLAIN:
+		{
+			FC_DrawAlign(GetFont(job->FontID), m_Renderer, static_cast<float>(textRect.x), static_cast<float>(textRect.y), horizontalTextAlignment, job->Text);
+		} break;
+
+		case TextRenderMode::BOX:
+		{
+			FC_DrawBoxAlign(GetFont(job->FontID), m_Renderer, textRect, horizontalTextAlignment, job->Text);
+		} break;
+
+		case TextRenderMode::INVALID:
+		default:
+			break;
+	}
+}
+
+void MEngineGraphics::DrawJobCaret(const RenderJob* job, const SDL_Rect& destinationRect, ColorData& inOutDrawColor)
+{
+	int32_t caretOffsetX = GetTextWidth(job->FontID, job->CaretPrefixText);
+	if (job->CaretIsAtEnd)
+		caretOffsetX += CARET_END_OF_STRING_OFFSET;
+
+	SetDrawColor(Colors[BLACK], inOutDrawColor); // TODODB: Make this a settable color
+	SDL_RenderDrawLine(m_Renderer, destinationRect.x + caretOffsetX, destinationRect.y + CARET_HEIGHT_OFFSET_TOP, destinationRect.x + caretOffsetX, destinationRect.y + GetLineHeight(job->FontID) - CARET_HEIGHT_OFFSET_BOTTOM);
+}
+
+void MEngineGraphics::BatchFillRect(const SDL_Rect& rect, const ColorData& color, ColorData& inOutDrawColor)
+{
+#if MENGINE_GEOMETRY_BATCHING
+	BeginRenderBatch(RenderBatchType::GEOMETRY, ColorData(), nullptr, inOutDrawColor);
+	AddBatchQuad(rect, color);
+#else
+	BeginRenderBatch(RenderBatchType::FILL_RECTS, color, nullptr, inOutDrawColor);
+	m_RenderBatch->Rects.push_back(rect);
+#endif
+	++m_RenderBatch->BatchedDrawCount;
+}
+
+void MEngineGraphics::BatchDrawRect(const SDL_Rect& rect, const ColorData& color, ColorData& inOutDrawColor)
+{
+#if MENGINE_GEOMETRY_BATCHING
+	if (rect.w <= 0 || rect.h <= 0)
+		return;
+
+	// The outline is made of one pixel wide quads covering the same pixels as SDL_RenderDrawRect
+	BeginRenderBatch(RenderBatchType::GEOMETRY, ColorData(), nullptr, inOutDrawColor);
+	AddBatchQuad({ rect.x, rect.y, rect.w, 1 }, color);
+	if (rect.h > 1)
+		AddBatchQuad({ rect.x, rect.y + rect.h - 1, rect.w, 1 }, color);
+
+	if (rect.h > 2)
+	{
+		AddBatchQuad({ rect.x, rect.y + 1, 1, rect.h - 2 }, color);
+		if (rect.w > 1)
+			AddBatchQuad({ rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2 }, color);
+	}
+#else
+	BeginRenderBatch(RenderBatchType::DRAW_RECTS, color, nullptr, inOutDrawColor);
+	m_RenderBatch->Rects.push_back(rect);
+#endif
+	++m_RenderBatch->BatchedDrawCount;
+}
+
+void MEngineGraphics::BatchTexture(const MEngineTexture& texture, const SDL_Rect& rect, ColorData& inOutDrawColor)
+{
+	// Textures packed into the same atlas page share the batch
+	BeginRenderBatch(RenderBatchType::TEXTURE, ColorData(), texture.Texture, inOutDrawColor);
+	m_RenderBatch->Rects.push_back(rect);
+	m_RenderBatch->SourceRects.push_back(texture.SourceRect);
+	++m_RenderBatch->BatchedDrawCount;
+}
+
+void MEngineGraphics::BeginRenderBatch(RenderBatchType type, const ColorData& color, SDL_Texture* texture, ColorData& inOutDrawColor)
+{
+	RenderBatch& batch = *m_RenderBatch;
+	if (batch.Type == type && batch.Color == color && batch.Texture == texture)
+		return;
+
+	FlushRenderBatch(inOutDrawColor);
+	batch.Type		= type;
+	batch.Color		= color;
+	batch.Texture	= texture;
+}
 
-	for (int i = 0; i < m_RenderJobs->size(); ++i)
+void MEngineGraphics::FlushRenderBatch(ColorData& inOutDrawColor)
+{
+	RenderBatch& batch = *m_RenderBatch;
+	switch (batch.Type)
 	{
-		const RenderJob* job = (*m_RenderJobs)[i]; // Guaranteed to have position data
-		if ((job->JobMask & JobTypeMask::RECTANGLE) != 0)
+		case RenderBatchType::FILL_RECTS:
+		{
+			SetDrawColor(batch.Color, inOutDrawColor);
+			SDL_RenderFillRects(m_Renderer, batch.Rects.data(), static_cast<int>(batch.Rects.size()));
+			++batch.DrawCallCount;
+		} break;
+
+		case RenderBatchType::DRAW_RECTS:
 		{
-			if (!job->FillColor.IsFullyTransparent())
+			SetDrawColor(batch.Color, inOutDrawColor);
+			SDL_RenderDrawRects(m_Renderer, batch.Rects.data(), static_cast<int>(batch.Rects.size()));
+			++batch.DrawCallCount;
+		} break;
+
+		case RenderBatchType::TEXTURE:
+		{
+#if MENGINE_GEOMETRY_BATCHING
+			int32_t textureWidth, textureHeight;
+			SDL_QueryTexture(batch.Texture, nullptr, nullptr, &textureWidth, &textureHeight);
+			for (int i = 0; i < batch.Rects.size(); ++i)
 			{
-				SDL_SetRenderDrawColor(m_Renderer, job->FillColor.R, job->FillColor.G, job->FillColor.B, job->FillColor.A);
-				SDL_RenderFillRect(m_Renderer, &job->DestinationRect);
+				const SDL_Rect& sourceRect = batch.SourceRects[i];
+				AddBatchQuad(batch.Rects[i], Colors[WHITE], static_cast<float>(sourceRect.x) / textureWidth, static_cast<float>(sourceRect.y) / textureHeight,
+					static_cast<float>(sourceRect.x + sourceRect.w) / textureWidth, static_cast<float>(sourceRect.y + sourceRect.h) / textureHeight);
 			}
 
-			if (!job->BorderColor.IsFullyTransparent())
+			int result = SDL_RenderGeometry(m_Renderer, batch.Texture, batch.Vertices.data(), static_cast<int>(batch.Vertices.size()), batch.Indices.data(), static_cast<int>(batch.Indices.size()));
+			if (result != 0)
+				MLOG_ERROR("Failed to render texture batch" << '\n' << "SDL error Code = " << result << "; SDL error description = \"" << SDL_GetError() << "\" \n", LOG_CATEGORY_GRAPHICS);
+			++batch.DrawCallCount;
+#else
+			for (int i = 0; i < batch.Rects.size(); ++i)
 			{
-				SDL_SetRenderDrawColor(m_Renderer, job->BorderColor.R, job->BorderColor.G, job->BorderColor.B, job->BorderColor.A);
-				SDL_RenderDrawRect(m_Renderer, &job->DestinationRect);
+				int result = SDL_RenderCopy(m_Renderer, batch.Texture, &batch.SourceRects[i], &batch.Rects[i]);
+				if (result != 0)
+					MLOG_ERROR("Failed to render texture batch" << '\n' << "SDL error Code = " << result << "; SDL error description = \"" << SDL_GetError() << "\" \n", LOG_CATEGORY_GRAPHICS);
+				++batch.DrawCallCount;
 			}
-		}
+#endif
+		} break;
 
-		if ((job->JobMask & JobTypeMask::TEXTURE) != 0)
+#if MENGINE_GEOMETRY_BATCHING
+		case RenderBatchType::GEOMETRY:
 		{
-			int result = SDL_RenderCopy(m_Renderer, (*m_Textures)[job->TextureID]->Texture, nullptr, &job->DestinationRect);
-			if (result != 0)
-				MLOG_ERROR("Failed to render texture with ID: " << job->TextureID << '\n' << "SDL error Code = " << result << "; SDL error description = \"" << SDL_GetError() << "\" \n", LOG_CATEGORY_GRAPHICS);
-		}
+			SDL_RenderGeometry(m_Renderer, nullptr, batch.Vertices.data(), static_cast<int>(batch.Vertices.size()), batch.Indices.data(), static_cast<int>(batch.Indices.size()));
+			++batch.DrawCallCount;
+		} break;
+#endif
+
+		case RenderBatchType::NONE:
+		default:
+			break;
+	}
+
+	batch.Type = RenderBatchType::NONE;
+	batch.Rects.clear();
+	batch.SourceRects.clear();
+#if MENGINE_GEOMETRY_BATCHING
+	batch.Vertices.clear();
+	batch.Indices.clear();
+#endif
+}
+
+#if MENGINE_GEOMETRY_BATCHING
+void MEngineGraphics::AddBatchQuad(const SDL_Rect& rect, const ColorData& color, float textureLeft, float textureTop, float textureRight, float textureBottom)
+{
+	RenderBatch& batch = *m_RenderBatch;
+	const int firstVertex = static_cast<int>(batch.Vertices.size());
+	const SDL_Color vertexColor = { color.R, color.G, color.B, color.A };
+	const float left	= static_cast<float>(rect.x);
+	const float top		= static_cast<float>(rect.y);
+	const float right	= static_cast<float>(rect.x + rect.w);
+	const float bottom	= static_cast<float>(rect.y + rect.h);
+
+	batch.Vertices.push_back({ { left, top }, vertexColor, { textureLeft, textureTop } });
+	batch.Vertices.push_back({ { right, top }, vertexColor, { textureRight, textureTop } });
+	batch.Vertices.push_back({ { right, bottom }, vertexColor, { textureRight, textureBottom } });
+	batch.Vertices.push_back({ { left, bottom }, vertexColor, { textureLeft, textureBottom } });
+
+	const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int i = 0; i < 6; ++i)
+	{
+		batch.Indices.push_back(firstVertex + quadIndices[i]);
+	}
+}
+#endif
+
+void MEngineGraphics::SetDrawColor(const ColorData& color, ColorData& inOutCurrentColor)
+{
+	if (color == inOutCurrentColor) // Consecutive jobs often share colors after sorting
+		return;
+
+	SDL_SetRenderDrawColor(m_Renderer, color.R, color.G, color.B, color.A);
+	inOutCurrentColor = color;
+}
+
+TextureID MEngineGraphics::AddSurface(SDL_Surface* surface, bool storeSurfaceInRAM, TextureID reservedTextureID)
+{
+	MEngineTexture* texture = nullptr;
+	int32_t atlasPageIndex;
+	SDL_Rect sourceRect;
+	if (PackIntoAtlas(surface, atlasPageIndex, sourceRect))
+	{
+		texture = new MEngineTexture((*m_AtlasPages)[atlasPageIndex]->Texture, atlasPageIndex, sourceRect, (storeSurfaceInRAM ? surface : nullptr));
+	}
+	else
+	{
+		SdlApiLock.lock();
+		SDL_Texture* sdlTexture = SDL_CreateTextureFromSurface(m_Renderer, surface);
+		SdlApiLock.unlock();
+		if (sdlTexture != nullptr)
+			texture = new MEngineTexture(sdlTexture, (storeSurfaceInRAM ? surface : nullptr));
+	}
+
+	if (texture == nullptr)
+	{
+		MLOG_ERROR("Failed to create texture from surface; SDL error = \"" << SDL_GetError() << "\"", LOG_CATEGORY_GRAPHICS);
+		SDL_FreeSurface(surface);
+		return TextureID::Invalid();
+	}
+
+	if (!storeSurfaceInRAM)
+		SDL_FreeSurface(surface);
+
+	return StoreTexture(texture, reservedTextureID);
+}
+
+TextureID MEngineGraphics::StoreTexture(MEngineTexture* texture, TextureID reservedTextureID)
+{
+	TextureID ID = reservedTextureID.IsValid() ? reservedTextureID : GetNextTextureID();
+	ID >= static_cast<int64_t>(m_Textures->size()) ? m_Textures->push_back(texture) : (*m_Textures)[ID] = texture;
+	return ID;
+}
 
-		if ((job->JobMask & JobTypeMask::TEXT) != 0)
+bool MEngineGraphics::PackIntoAtlas(SDL_Surface* surface, int32_t& outPageIndex, SDL_Rect& outSourceRect)
+{
+	if (surface->w > ATLAS_MAX_ENTRY_SIZE || surface->h > ATLAS_MAX_ENTRY_SIZE)
+		return false;
+
+	uint32_t colorKey;
+	if (SDL_GetColorKey(surface, &colorKey) == 0) // Color keyed surfaces are left to SDL_CreateTextureFromSurface, which turns the key into transparency
+		return false;
+
+	std::lock_guard<std::mutex> atlasLock(m_AtlasLock);
+	SdlApiLock.lock();
+
+	SDL_Surface* convertedSurface = surface;
+	if (surface->format->format != SDL_PIXELFORMAT_ARGB8888)
+		convertedSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+
+	bool result = false;
+	if (convertedSurface != nullptr)
+	{
+		// The padding goes to the right and below each entry; the top and left edges of a page clamp to themselves
+		int32_t posX, posY;
+		int32_t pageIndex = -1;
+		for (int i = 0; i < m_AtlasPages->size(); ++i)
 		{
-			switch (job->TextRenderMode)
+			if ((*m_AtlasPages)[i]->Packer.Insert(surface->w + ATLAS_ENTRY_PADDING, surface->h + ATLAS_ENTRY_PADDING, posX, posY))
 			{
-				case TextRenderMode::PLAIN:
-				{
-					FC_DrawAlign(GetFont(job->FontID), m_Renderer, static_cast<float>(job->TextRect.x), static_cast<float>(job->TextRect.y), job->HorizontalTextAlignment, job->Text);
-				} break;
+				pageIndex = i;
+				break;
+			}
+		}
 
-				case TextRenderMode::BOX:
-				{
-					FC_DrawBoxAlign(GetFont(job->FontID), m_Renderer, job->TextRect, job->HorizontalTextAlignment, job->Text);
-				} break;
+		if (pageIndex < 0)
+		{
+			SDL_Texture* pageTexture = SDL_CreateTexture(m_Renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+			if (pageTexture != nullptr)
+			{
+				ClearAtlasPageTexture(pageTexture); // Newly created textures hold undefined pixels
+				SDL_SetTextureBlendMode(pageTexture, SDL_BLENDMODE_BLEND);
 
-				case TextRenderMode::INVALID:
-				default:
-					break;
+				m_AtlasPages->push_back(new AtlasPage(pageTexture));
+				pageIndex = static_cast<int32_t>(m_AtlasPages->size() - 1);
+				m_AtlasPages->back()->Packer.Insert(surface->w + ATLAS_ENTRY_PADDING, surface->h + ATLAS_ENTRY_PADDING, posX, posY);
 			}
+			else
+				MLOG_WARNING("Failed to create texture atlas page; SDL error = \"" << SDL_GetError() << "\"", LOG_CATEGORY_GRAPHICS);
 		}
 
-		if ((job->JobMask & JobTypeMask::CARET) != 0)
+		if (pageIndex >= 0)
 		{
-			SDL_SetRenderDrawColor(m_Renderer, Colors[BLACK].R, Colors[BLACK].G, Colors[BLACK].B, Colors[BLACK].A); // TODODB: Make this a settable color
-			SDL_RenderDrawLine(m_Renderer, job->DestinationRect.x + job->CaretOffsetX, job->DestinationRect.y + CARET_HEIGHT_OFFSET_TOP, job->DestinationRect.x + job->CaretOffsetX, job->DestinationRect.y + GetLineHeight(job->FontID) - CARET_HEIGHT_OFFSET_BOTTOM);
+			AtlasPage& page = *(*m_AtlasPages)[pageIndex];
+			outSourceRect = { posX, posY, surface->w, surface->h };
+			if (SDL_UpdateTexture(page.Texture, &outSourceRect, convertedSurface->pixels, convertedSurface->pitch) == 0)
+			{
+				++page.EntryCount;
+				outPageIndex = pageIndex;
+				result = true;
+			}
+			else
+				MLOG_WARNING("Failed to upload texture to atlas page; SDL error = \"" << SDL_GetError() << "\"", LOG_CATEGORY_GRAPHICS); // The area stays reserved until the page empties
 		}
+
+		if (convertedSurface != surface)
+			SDL_FreeSurface(convertedSurface);
+	}
+
+	SdlApiLock.unlock();
+	return result;
+}
+
+void MEngineGraphics::ReleaseAtlasEntry(int32_t pageIndex)
+{
+	// The packer cannot free single areas, so the area of an unloaded entry is only reclaimed once its whole page is empty
+	std::lock_guard<std::mutex> atlasLock(m_AtlasLock);
+	AtlasPage& page = *(*m_AtlasPages)[pageIndex];
+	if (--page.EntryCount == 0)
+	{
+		page.Packer.Reset();
+
+		// Entries packed into the reclaimed area would otherwise sample the old pixels through their padding
+		SdlApiLock.lock();
+		ClearAtlasPageTexture(page.Texture);
+		SdlApiLock.unlock();
 	}
+}
+
+void MEngineGraphics::ClearAtlasPageTexture(SDL_Texture* pageTexture)
+{
+	// The padding around the entries must stay transparent; the caller holds the SDL API lock
+	std::vector<uint32_t> clearPixels(ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE, 0);
+	SDL_UpdateTexture(pageTexture, nullptr, clearPixels.data(), ATLAS_PAGE_SIZE * sizeof(uint32_t));
+}
+
+void MEngineGraphics::TakeLatestRenderSnapshot()
+{
+	if ((m_ReadyRenderSnapshot & RENDER_SNAPSHOT_NEW_BIT) == 0)
+		return;
 
-	for (int i = 0; i < m_RenderJobs->size(); ++i)
+	// The current front snapshot may be overwritten as soon as it has been handed back, so remember its positions first
+	const RenderSnapshot& previousSnapshot = m_RenderSnapshots[m_FrontRenderSnapshot];
+	const std::vector<RenderJob>& previousJobs = previousSnapshot.JobList.Jobs;
+	m_InterpolationSourceCandidate->clear();
+	for (int i = 0; i < previousJobs.size(); ++i)
 	{
-		delete (*m_RenderJobs)[i];
+		m_InterpolationSourceCandidate->push_back({ previousJobs[i].EntityID, previousJobs[i].DestinationRect });
 	}
-	m_RenderJobs->clear();
+	std::sort(m_InterpolationSourceCandidate->begin(), m_InterpolationSourceCandidate->end(), IsLowerEntityID);
+	uint64_t previousSimulationStep = previousSnapshot.SimulationStep;
 
-	// Restore draw color
-	SDL_SetRenderDrawColor(m_Renderer, startingDrawColor[0], startingDrawColor[1], startingDrawColor[2], startingDrawColor[3]);
+	m_FrontRenderSnapshot = m_ReadyRenderSnapshot.exchange(m_FrontRenderSnapshot) & ~RENDER_SNAPSHOT_NEW_BIT;
+
+	if (m_RenderSnapshots[m_FrontRenderSnapshot].SimulationStep != previousSimulationStep) // Snapshots published by the main thread between steps keep interpolating from the same source
+		std::swap(m_InterpolationSource, m_InterpolationSourceCandidate);
+}
+
+bool MEngineGraphics::ExecuteRenderStatsCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse)
+{
+	if (parameterCount != 0)
+	{
+		*outResponse = "Wrong number of parameters supplied";
+		return false;
+	}
+
+	const RetainedRenderList& renderList = *m_RenderList;
+	std::stringstream response;
+	response << "Render list: " << renderList.Jobs.size() << " jobs; " << renderList.LastRebuiltJobCount << " rebuilt for the last frame\n";
+	response << renderList.RebuiltJobCount << " jobs rebuilt, " << renderList.SortCount << " sorts and " << renderList.FullRebuildCount << " full rebuilds since start\n";
+	response << "Last frame: " << m_RenderBatch->LastFrameBatchedDrawCount << " batched draws flushed in " << m_RenderBatch->LastFrameDrawCallCount << " draw calls\n";
+	response << "Texture atlas: " << m_AtlasPages->size() << " pages of " << ATLAS_PAGE_SIZE << 'x' << ATLAS_PAGE_SIZE;
+	*outResponse = response.str();
+
+	return true;
 }
\ No newline at end of file
@@ -1,15 +1,24 @@
 #pragma once
 #include "Interface/MEngineGraphics.h"
 #include "Interface/MEngineColor.h"
+#include "Interface/MEngineInternalComponents.h"
 #include "Interface/MEngineTypes.h"
 #include <MUtilityBitset.h>
 #include <SDL.h>
 #include <SDL_FontCache.h>
+#include <vector>
 
 struct SurfaceToTextureJob;
 
+namespace MEngine
+{
+	struct ComponentEvent;
+}
+
 namespace MEngineGraphics
 {
+	constexpr MEngine::ComponentMask RENDERED_COMPONENT_TYPES = MEngine::POS_SIZE_COMPONENT_MASK | MEngine::RECTANGLE_RENDERING_COMPONENT_MASK | MEngine::TEXTURE_RENDERING_COMPONENT_MASK | MEngine::TEXT_COMPONENT_MASK;
+
 	enum class JobTypeMask : MUtility::BitSet
 	{
 		INVALID	= 0,
@@ -34,36 +43,54 @@ namespace MEngineGraphics
 		MEngineTexture(SDL_Texture* sdlTexture, SDL_Surface* sdlSurface = nullptr) : Texture(sdlTexture), Surface(sdlSurface)
 		{
 			SDL_QueryTexture(sdlTexture, &Format, &Access, &Width, &Height);
+			SourceRect = { 0, 0, Width, Height };
+		}
+
+		MEngineTexture(SDL_Texture* atlasPageTexture, int32_t atlasPageIndex, const SDL_Rect& sourceRect, SDL_Surface* sdlSurface = nullptr) : Texture(atlasPageTexture), Surface(sdlSurface), SourceRect(sourceRect), AtlasPageIndex(atlasPageIndex)
+		{
+			SDL_QueryTexture(atlasPageTexture, &Format, &Access, nullptr, nullptr);
+			Width	= sourceRect.w;
+			Height	= sourceRect.h;
+		}
+
+		MEngineTexture(const MEngineTexture& parent, MEngine::TextureID parentID, const SDL_Rect& sourceRect) : Texture(parent.Texture), Surface(nullptr), SourceRect(sourceRect), ParentID(parentID)
+		{
+			Width	= sourceRect.w;
+			Height	= sourceRect.h;
+			Format	= parent.Format;
+			Access	= parent.Access;
 		}
 
 		MEngineTexture(const MEngineTexture& other) = delete;
 
 		~MEngineTexture()
 		{
-			SDL_DestroyTexture(Texture);
+			if (AtlasPageIndex < 0 && !ParentID.IsValid()) // Atlas pages are shared and owned by the atlas and regions share the texture of their parent
+				SDL_DestroyTexture(Texture);
 
 			if(Surface)
 				SDL_FreeSurface(Surface);
 		}
 
-		SDL_Texture*	Texture;
+		SDL_Texture*	Texture; // The atlas page when the texture has been packed into an atlas
 		SDL_Surface*	Surface;
+		SDL_Rect		SourceRect; // The part of Texture that holds the texture
+		int32_t			AtlasPageIndex = -1;
+		MEngine::TextureID	ParentID; // Only valid for regions; always refers to a texture that is not a region itself
 		int32_t			Width;
 		int32_t			Height;
 		uint32_t		Format;
 		int32_t			Access;
 	};
 
-	struct RenderJob
+	struct RenderJob // Trivially destructible so that a frame's jobs can be discarded without touching them; all pointers point into the frame arena the jobs were created with
 	{
-		RenderJob() {}
-		~RenderJob(){ delete[] Text; Text = nullptr; }
-		RenderJob(const RenderJob& other) = delete;
-
 		// Genric
 		JobTypeMask JobMask				= JobTypeMask::INVALID;
+		MEngine::EntityID EntityID;
 		SDL_Rect DestinationRect		= {0,0,0,0};
 		uint32_t Depth					= 0;
+		uint64_t SortKey				= 0; // Orders the render list; see CalcRenderSortKey
 
 		// Texture
 		MEngine::TextureID TextureID;
@@ -72,22 +99,14 @@ namespace MEngineGraphics
 		MEngine::ColorData FillColor	= MEngine::PredefinedColors::Colors[MEngine::PredefinedColors::TRANSPARENT_];
 		MEngine::ColorData BorderColor	= MEngine::PredefinedColors::Colors[MEngine::PredefinedColors::TRANSPARENT_];
 
-		// Text
-		TextRenderMode	TextRenderMode			= TextRenderMode::INVALID;
-		MEngine::FontID	FontID;
-		char*			Text					= nullptr;
-		FC_AlignEnum	HorizontalTextAlignment = FC_ALIGN_LEFT;
-		SDL_Rect		TextRect				= {0,0,0,0};
-		int32_t			CaretOffsetX			= -1;
-
-		void CopyText(const char* str)
-		{
-			if (Text != nullptr)
-				delete[] Text;
-
-			Text = new char[strlen(str) + 1];
-			strcpy(Text, str);
-		}
+		// Text; laid out when the job is executed since measuring text requires the font cache, which may only be used from the render thread
+		TextRenderMode			TextRenderMode		= TextRenderMode::INVALID;
+		MEngine::FontID			FontID;
+		const char*				Text				= nullptr;
+		MEngine::TextAlignment	TextAlignment		= MEngine::TextAlignment::BottomLeft;
+		uint32_t				ScrolledLinesCount	= 0;
+		const char*				CaretPrefixText		= nullptr; // The text in front of the caret, measured to place it
+		bool					CaretIsAtEnd		= false;
 	};
 
 	bool Initialize(const char* appName, int32_t windowPosX, int32_t windowPosY, int32_t windowWidth, int32_t windowHeight);
@@ -101,6 +120,8 @@ namespace MEngineGraphics
 	SDL_Window*		GetWindow();
 
 	void Render();
+	void PublishRenderSnapshot(); // Captures the render state of the world for Render to draw; only used while the simulation runs on its own thread and must be called while holding the simulation lock
+	void HandleComponentEvents(const std::vector<MEngine::ComponentEvent>& events); // Marks the render jobs of the changed entities for rebuilding
 }
 
 struct SurfaceToTextureJob
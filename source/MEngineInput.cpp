@@ -194,6 +194,11 @@ void MEngineInput::Update()
 		m_TextInputCaretIndex = m_TextInputStringReference->length();
 }
 
+const std::string* MEngineInput::GetTextInputString()
+{
+	return m_TextInputStringReference;
+}
+
 bool MEngineInput::HandleEvent(const SDL_Event& sdlEvent)
 {
 	bool consumedEvent = false;
@@ -1,6 +1,7 @@
 #pragma once
 #include "Interface/MEngineInput.h"
 #include <SDL.h>
+#include <string>
 
 namespace MEngineInput
 {
@@ -8,4 +9,5 @@ namespace MEngineInput
 	void Shutdown();
 	void Update();
 	bool HandleEvent(const SDL_Event& sdlEvent);
+	const std::string* GetTextInputString(); // The string being edited by text input; null when text input is inactive
 }
\ No newline at end of file
@@ -3,13 +3,13 @@
 #include "Interface/MengineComponentManager.h"
 #include <MUtilityLog.h>
 #include <MUtilityMacros.h>
-#include <vector>
+#include <MUtilityPlatformDefinitions.h>
+
+#define LOG_CATEGORY_INTERNAL_COMPONENTS "MEngineInternalComponents"
 
 namespace MEngineInternalComponents
 {
 	void RegisterComponentsTypes();
-
-	std::vector<MEngine::ComponentMask>* m_ComponentMasks;
 }
 
 using namespace MEngine;
@@ -33,17 +33,16 @@ void TextComponent::Destroy()
 
 void MEngineInternalComponents::Initialize()
 {
-	m_ComponentMasks = new std::vector<ComponentMask>();
 	RegisterComponentsTypes();
 }
 
 void MEngineInternalComponents::Shutdown()
 {
-	for (int i = 0; i < m_ComponentMasks->size(); ++i)
-	{
-		MEngine::UnregisterComponentType((*m_ComponentMasks)[i]);
-	}
-	delete m_ComponentMasks;
+	PosSizeComponent::Unregister();
+	RectangleRenderingComponent::Unregister();
+	TextureRenderingComponent::Unregister();
+	ButtonComponent::Unregister();
+	TextComponent::Unregister();
 }
 
 // ---------- LOCAL ----------
@@ -55,4 +54,10 @@ void MEngineInternalComponents::RegisterComponentsTypes()
 	TextureRenderingComponent::Register(TextureRenderingComponent(), "TextureRenderingComponent");
 	ButtonComponent::Register(ButtonComponent(), "ButtonComponent");
 	TextComponent::Register(TextComponent(), "TextBoxComponent");
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (PosSizeComponent::GetComponentMask() != POS_SIZE_COMPONENT_MASK || RectangleRenderingComponent::GetComponentMask() != RECTANGLE_RENDERING_COMPONENT_MASK ||
+		TextureRenderingComponent::GetComponentMask() != TEXTURE_RENDERING_COMPONENT_MASK || ButtonComponent::GetComponentMask() != BUTTON_COMPONENT_MASK || TextComponent::GetComponentMask() != TEXT_COMPONENT_MASK)
+		MLOG_ERROR("The internal component types did not receive their expected component masks; all internal component types must be registered before any other component type", LOG_CATEGORY_INTERNAL_COMPONENTS);
+#endif
 }
\ No newline at end of file
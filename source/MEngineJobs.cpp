@@ -0,0 +1,360 @@
+#include "Interface/MEngineJobs.h"
+#include "Interface/MEngineWorld.h"
+#include "MEngineComponentManagerInternal.h"
+#include "MEngineJobsInternal.h"
+#include "MEngineWorldInternal.h"
+#include "World.h"
+#include <MUtilityLog.h>
+#include <MUtilityThreading.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_CATEGORY_JOBS "MEngineJobs"
+
+using namespace MEngine;
+
+namespace MEngineJobs
+{
+	constexpr int64_t MAX_JOB_COUNT = 4096; // Number of job slots; must be a power of two
+
+	struct Job
+	{
+		std::atomic<int64_t>	ID							= -1;
+		std::atomic<bool>		IsFinished					= true; // Written while holding DependentsLock
+		std::atomic<int32_t>	PendingDependencyCount		= 0;
+		JobFunction				Function;
+		std::vector<int64_t>	Dependents;
+		std::mutex				DependentsLock;
+	};
+
+	struct JobQueue // The owning worker takes jobs from the back and other threads steal from the front
+	{
+		std::deque<int64_t>	JobIDs;
+		std::mutex			Lock;
+	};
+
+	Job& GetJob(int64_t ID);
+	void PushJob(int64_t ID);
+	bool TryExecuteJob();
+	void ExecuteJob(int64_t ID);
+	void WorkerMain(int32_t workerIndex);
+
+	Job*						m_Jobs				= nullptr;
+	std::vector<JobQueue*>*		m_Queues			= nullptr; // One per worker and a last one shared by all other threads
+	std::vector<std::thread>*	m_Workers			= nullptr;
+	std::atomic<int64_t>		m_NextJobID			= 0;
+	std::atomic<int32_t>		m_QueuedJobCount	= 0;
+	std::atomic<bool>			m_ShouldStop		= false;
+	std::mutex					m_WakeLock;
+	std::condition_variable		m_WakeCondition;
+
+	thread_local int32_t t_QueueIndex = -1;
+}
+
+using namespace MEngineJobs;
+
+// ---------- INTERFACE ----------
+
+JobID MEngine::ScheduleJob(JobFunction function, const JobID* dependencies, int32_t dependencyCount)
+{
+	int64_t ID = m_NextJobID++;
+	Job& job = GetJob(ID);
+	while (!job.IsFinished) // The slot is still used by a job scheduled MAX_JOB_COUNT jobs ago
+	{
+		if (!TryExecuteJob())
+			std::this_thread::yield();
+	}
+
+	job.DependentsLock.lock();
+	job.ID						= ID;
+	job.Function				= std::move(function);
+	job.IsFinished				= false;
+	job.PendingDependencyCount	= 1; // Keeps the job from being queued while the dependencies are registered
+	job.Dependents.clear();
+	job.DependentsLock.unlock();
+
+	for (int i = 0; i < dependencyCount; ++i)
+	{
+		if (!dependencies[i].IsValid())
+			continue;
+
+		Job& dependency = GetJob(dependencies[i]);
+		std::lock_guard<std::mutex> lock(dependency.DependentsLock);
+		if (dependency.ID == dependencies[i] && !dependency.IsFinished)
+		{
+			dependency.Dependents.push_back(ID);
+			++job.PendingDependencyCount;
+		}
+	}
+
+	if (--job.PendingDependencyCount == 0)
+		PushJob(ID);
+
+	return JobID(ID);
+}
+
+JobID MEngine::ScheduleJob(JobFunction function, JobID dependency)
+{
+	return ScheduleJob(std::move(function), &dependency, 1);
+}
+
+bool MEngine::WaitForJob(JobID ID)
+{
+	if (!ID.IsValid())
+	{
+		MLOG_WARNING("Attempted to wait for a job using an invalid job ID", LOG_CATEGORY_JOBS);
+		return false;
+	}
+
+	while (!IsJobFinished(ID))
+	{
+		if (!TryExecuteJob())
+			std::this_thread::yield();
+	}
+	return true;
+}
+
+bool MEngine::IsJobFinished(JobID ID)
+{
+	const Job& job = GetJob(ID);
+	return job.ID != ID || job.IsFinished; // A reused slot means that the job has finished
+}
+
+void MEngine::ParallelFor(int32_t begin, int32_t end, int32_t grainSize, const ParallelForFunction& function)
+{
+	if (end <= begin)
+		return;
+
+	grainSize = std::max(grainSize, 1);
+	if (end - begin <= grainSize || m_Workers->empty())
+	{
+		function(begin, end);
+		return;
+	}
+
+	std::vector<JobID> batchJobs;
+	batchJobs.reserve((end - begin) / grainSize);
+	for (int32_t batchBegin = begin + grainSize; batchBegin < end; batchBegin += grainSize) // The first batch is run by the calling thread
+	{
+		int32_t batchEnd = std::min(batchBegin + grainSize, end);
+		batchJobs.push_back(ScheduleJob([&function, batchBegin, batchEnd]() { function(batchBegin, batchEnd); }));
+	}
+
+	function(begin, begin + grainSize);
+
+	for (int i = 0; i < batchJobs.size(); ++i)
+	{
+		WaitForJob(batchJobs[i]);
+	}
+}
+
+int32_t MEngine::GetWorkerCount()
+{
+	return static_cast<int32_t>(m_Workers->size());
+}
+
+void MEngine::ParallelForEntities(ComponentMask componentMask, int32_t grainSize, const std::function<void(EntityID ID)>& function, MaskMatchMode matchMode)
+{
+	std::vector<EntityID> entities;
+	GetEntitiesMatchingMask(componentMask, entities, matchMode);
+
+	WorldID worldID = GetThreadWorld();
+	bool beganConcurrentAccess = !IsInConcurrentAccess() && BeginConcurrentAccess();
+	ParallelFor(0, static_cast<int32_t>(entities.size()), grainSize, [&](int32_t begin, int32_t end)
+	{
+		const WorldID previousThreadWorld = MEngineWorld::GetThreadWorldOverride();
+		bool targetsOtherWorld = GetThreadWorld() != worldID; // Workers need to target the same world as the calling thread
+		if (targetsOtherWorld)
+			SetThreadWorld(worldID);
+
+		for (int32_t i = begin; i < end; ++i)
+		{
+			function(entities[i]);
+		}
+
+		if (targetsOtherWorld)
+			SetThreadWorld(previousThreadWorld);
+	});
+
+	if (beganConcurrentAccess)
+		EndConcurrentAccess();
+}
+
+void MEngine::ParallelForComponentBuffer(uint32_t componentBufferIndex, int32_t grainSize, const std::function<void(Component* component)>& function)
+{
+	const ComponentBuffer* buffer = componentBufferIndex < MEngineComponentManager::MAX_COMPONENTS ? MEngineWorld::GetCurrentWorld()->GetComponentBuffer(1ULL << componentBufferIndex) : nullptr;
+	if (buffer == nullptr)
+	{
+		MLOG_WARNING("Attempted to run a parallel for over a non existent component buffer; buffer index = " << componentBufferIndex, LOG_CATEGORY_JOBS);
+		return;
+	}
+
+	// Gather the active slots up front so that the workers don't contend for the ID bank
+	std::vector<uint32_t> activeIndices;
+	activeIndices.reserve(buffer->GetActiveCount());
+	const ComponentIDBank& IDs = buffer->GetIDs();
+	for (uint32_t i = 0; i < buffer->GetTotalCount(); ++i)
+	{
+		if (IDs.IsIDActive(i))
+			activeIndices.push_back(i);
+	}
+
+	bool beganConcurrentAccess = !IsInConcurrentAccess() && BeginConcurrentAccess();
+	ParallelFor(0, static_cast<int32_t>(activeIndices.size()), grainSize, [&](int32_t begin, int32_t end)
+	{
+		for (int32_t i = begin; i < end; ++i)
+		{
+			function(buffer->GetComponent(activeIndices[i]));
+		}
+	});
+
+	if (beganConcurrentAccess)
+		EndConcurrentAccess();
+}
+
+// ---------- INTERNAL ----------
+
+void MEngineJobs::Initialize()
+{
+	int32_t workerCount = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()) - 1, 1); // The main thread helps out when it waits for jobs
+
+	m_Jobs		= new Job[MAX_JOB_COUNT];
+	m_Queues	= new std::vector<JobQueue*>();
+	m_Workers	= new std::vector<std::thread>();
+	m_ShouldStop = false;
+
+	for (int i = 0; i < workerCount + 1; ++i)
+	{
+		m_Queues->push_back(new JobQueue());
+	}
+
+	for (int i = 0; i < workerCount; ++i)
+	{
+		m_Workers->emplace_back(WorkerMain, i);
+	}
+}
+
+void MEngineJobs::Shutdown()
+{
+	m_WakeLock.lock();
+	m_ShouldStop = true;
+	m_WakeLock.unlock();
+	m_WakeCondition.notify_all();
+
+	for (int i = 0; i < m_Workers->size(); ++i)
+	{
+		MUtilityThreading::JoinThread((*m_Workers)[i]);
+	}
+	delete m_Workers;
+
+	for (int i = 0; i < m_Queues->size(); ++i)
+	{
+		delete (*m_Queues)[i];
+	}
+	delete m_Queues;
+	delete[] m_Jobs;
+}
+
+// ---------- LOCAL ----------
+
+Job& MEngineJobs::GetJob(int64_t ID)
+{
+	return m_Jobs[ID & (MAX_JOB_COUNT - 1)];
+}
+
+void MEngineJobs::PushJob(int64_t ID)
+{
+	JobQueue* queue = t_QueueIndex >= 0 ? (*m_Queues)[t_QueueIndex] : m_Queues->back();
+
+	++m_QueuedJobCount; // Incremented before the push so the count never goes negative
+	queue->Lock.lock();
+	queue->JobIDs.push_back(ID);
+	queue->Lock.unlock();
+
+	m_WakeLock.lock(); // Makes sure that a worker checking for work either sees the new job or is already waiting for the notification
+	m_WakeLock.unlock();
+	m_WakeCondition.notify_one();
+}
+
+bool MEngineJobs::TryExecuteJob()
+{
+	int32_t queueCount = static_cast<int32_t>(m_Queues->size());
+	int32_t ownQueueIndex = t_QueueIndex >= 0 ? t_QueueIndex : queueCount - 1;
+	int64_t ID = -1;
+
+	JobQueue* ownQueue = (*m_Queues)[ownQueueIndex];
+	ownQueue->Lock.lock();
+	if (!ownQueue->JobIDs.empty())
+	{
+		ID = ownQueue->JobIDs.back();
+		ownQueue->JobIDs.pop_back();
+	}
+	ownQueue->Lock.unlock();
+
+	for (int i = 1; i < queueCount && ID < 0; ++i) // Steal the oldest job from another queue
+	{
+		JobQueue* victimQueue = (*m_Queues)[(ownQueueIndex + i) % queueCount];
+		victimQueue->Lock.lock();
+		if (!victimQueue->JobIDs.empty())
+		{
+			ID = victimQueue->JobIDs.front();
+			victimQueue->JobIDs.pop_front();
+		}
+		victimQueue->Lock.unlock();
+	}
+
+	if (ID < 0)
+		return false;
+
+	--m_QueuedJobCount;
+	ExecuteJob(ID);
+	return true;
+}
+
+void MEngineJobs::ExecuteJob(int64_t ID)
+{
+	Job& job = GetJob(ID);
+	JobFunction function = std::move(job.Function); // Releases the captures of the function as soon as it has run
+
+	// Jobs run on whichever thread picks them up, including threads waiting in WaitForJob, so they must not inherit the world that thread targets
+	const WorldID previousThreadWorld = MEngineWorld::GetThreadWorldOverride();
+	if (previousThreadWorld.IsValid())
+		SetThreadWorld(WorldID::Invalid());
+
+	function();
+
+	if (previousThreadWorld.IsValid())
+		SetThreadWorld(previousThreadWorld);
+
+	std::vector<int64_t> dependents;
+	job.DependentsLock.lock();
+	job.IsFinished = true;
+	dependents.swap(job.Dependents);
+	job.DependentsLock.unlock();
+
+	for (int i = 0; i < dependents.size(); ++i)
+	{
+		if (--GetJob(dependents[i]).PendingDependencyCount == 0)
+			PushJob(dependents[i]);
+	}
+}
+
+void MEngineJobs::WorkerMain(int32_t workerIndex)
+{
+	t_QueueIndex = workerIndex;
+	while (true)
+	{
+		if (TryExecuteJob())
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_WakeLock);
+		m_WakeCondition.wait(lock, [] { return m_ShouldStop || m_QueuedJobCount > 0; });
+		if (m_ShouldStop && m_QueuedJobCount <= 0) // Queued jobs are finished before shutting down
+			break;
+	}
+}
\ No newline at end of file
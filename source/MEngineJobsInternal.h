@@ -0,0 +1,8 @@
+#pragma once
+#include "Interface/MEngineJobs.h"
+
+namespace MEngineJobs
+{
+	void Initialize();
+	void Shutdown();
+}
\ No newline at end of file
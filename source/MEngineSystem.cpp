@@ -1,3 +1,111 @@
 #include "Interface/MengineSystem.h"
+#include "Interface/MEngineEntityManager.h"
+#include <SDL_timer.h>
+#include <vector>
 
-CREATE_NAMESPACED_BITFLAG_OPERATOR_DEFINITIONS(MEngine, SystemSettings);
\ No newline at end of file
+using namespace MEngine;
+
+CREATE_NAMESPACED_BITFLAG_OPERATOR_DEFINITIONS(MEngine, SystemSettings);
+
+bool TrackedEntities::Add(EntityID ID)
+{
+	if (Contains(ID))
+		return false;
+
+	if (ID >= static_cast<int32_t>(m_Positions.size()))
+		m_Positions.resize(ID + 1, -1);
+
+	m_Positions[ID] = static_cast<int32_t>(m_Entities.size());
+	m_Entities.push_back(ID);
+	return true;
+}
+
+bool TrackedEntities::Remove(EntityID ID)
+{
+	if (!Contains(ID))
+		return false;
+
+	const int32_t position	= m_Positions[ID];
+	const EntityID lastID	= m_Entities.back();
+	m_Entities[position]	= lastID;
+	m_Positions[lastID]		= position;
+	m_Entities.pop_back();
+	m_Positions[ID] = -1;
+	return true;
+}
+
+bool TrackedEntities::Contains(EntityID ID) const
+{
+	return ID.IsValid() && ID < static_cast<int32_t>(m_Positions.size()) && m_Positions[ID] >= 0;
+}
+
+void TrackedEntities::Clear()
+{
+	for (int i = 0; i < m_Entities.size(); ++i)
+	{
+		m_Positions[m_Entities[i]] = -1;
+	}
+	m_Entities.clear();
+}
+
+void TimeSliceContext::Begin(uint64_t workCount)
+{
+	Cursor					= 0;
+	m_RemainingWorkCount	= workCount;
+	m_SliceCount			= 0;
+	m_IsInProgress			= true;
+}
+
+void TimeSliceContext::Finish()
+{
+	m_RemainingWorkCount	= 0;
+	m_IsInProgress			= false;
+}
+
+bool TimeSliceContext::ShouldYield() const
+{
+	return SDL_GetPerformanceCounter() >= m_SliceDeadlineTicks;
+}
+
+void TimeSliceContext::BeginSlice()
+{
+	m_SliceStartTicks		= SDL_GetPerformanceCounter();
+	m_SliceDeadlineTicks	= m_SliceStartTicks + static_cast<uint64_t>(m_BudgetMilliseconds * SDL_GetPerformanceFrequency() / 1000.0);
+}
+
+void TimeSliceContext::EndSlice()
+{
+	m_LastSliceMilliseconds = static_cast<float>((SDL_GetPerformanceCounter() - m_SliceStartTicks) * 1000.0 / SDL_GetPerformanceFrequency());
+	++m_SliceCount;
+}
+
+void MEngine::ApplyComponentEvents(const ComponentEvents& events, ComponentMask requiredComponentTypes, TrackedEntities& inOutEntities)
+{
+	if (events.FullRescanRequired)
+	{
+		std::vector<EntityID> matchingEntities;
+		GetEntitiesMatchingMask(requiredComponentTypes, matchingEntities, MaskMatchMode::Partial);
+
+		inOutEntities.Clear();
+		for (int i = 0; i < matchingEntities.size(); ++i)
+		{
+			inOutEntities.Add(matchingEntities[i]);
+		}
+		return;
+	}
+
+	// Removals are handled first and both passes check the current state of the world so that the order of events within the frame doesn't matter
+	for (int i = 0; i < events.Removed.size(); ++i)
+	{
+		EntityID ID = events.Removed[i].first;
+		if (!IsEntityIDValid(ID) || (GetComponentMask(ID) & requiredComponentTypes) != requiredComponentTypes)
+			inOutEntities.Remove(ID);
+	}
+
+	for (int i = 0; i < events.Added.size(); ++i)
+	{
+		EntityID ID = events.Added[i].first;
+		if (IsEntityIDValid(ID) && (GetComponentMask(ID) & requiredComponentTypes) == requiredComponentTypes)
+			inOutEntities.Add(ID);
+	}
+}
\ No newline at end of file
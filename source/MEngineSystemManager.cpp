@@ -1,31 +1,115 @@
 #include "Interface/MEngineSystem.h"
 #include "Interface/MengineConsole.h"
+#include "Interface/MEngineJobs.h"
 #include "Interface/MEngineSettings.h"
+#include "Interface/MEngineTimers.h"
+#include "Interface/MEngineUtility.h"
+#include "Interface/MEngineWorld.h"
+#include "MEngineEventBusInternal.h"
+#include "MEngineGraphicsInternal.h"
 #include "MEngineSystemManagerInternal.h"
+#include "MEngineTasksInternal.h"
+#include "MEngineTimersInternal.h"
+#include "MEngineWorldInternal.h"
+#include "World.h"
 #include "ButtonSystem.h"
 #include "TextBoxSystem.h"
 #include "FrameCounter.h"
+#include "SampleBuffer.h"
 #include <MUtilityIDBank.h>
 #include <MUtilityLog.h>
+#include <SDL_timer.h>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <queue>
 #include <set>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #define LOG_CATEGORY_SYSTEM_MANAGER "MEngineSystemManager"
 
-typedef std::vector<std::pair<MEngine::SystemID, uint32_t>> GameModeSystemList;
-typedef std::vector<GameModeSystemList> GameModeList;
+constexpr uint32_t	SYSTEM_STATISTICS_SAMPLE_COUNT	= 256;
+constexpr double	MILLISECONDS_PER_SECOND			= 1000.0;
+
+struct ExecutionPlanEntry
+{
+	MEngine::System*	System;
+	uint32_t			FirstDependency; // Index into ExecutionPlan::Dependencies
+	uint32_t			DependencyCount;
+	uint32_t			SimulationStepDivider; // The simulation layer is updated on every SimulationStepDivider:th step
+	uint32_t			SimulationStepOffset; // Staggers systems with dividers so that their updates are spread over different steps
+};
+
+struct ExecutionPlan // The systems of a game mode in update order; each entry may overlap with every earlier entry that it does not depend on
+{
+	std::vector<ExecutionPlanEntry>	Entries;
+	std::vector<uint32_t>			Dependencies; // Indices of the earlier entries that each entry has to wait for
+};
+
+struct GameMode
+{
+	std::vector<std::pair<MEngine::SystemID, uint32_t>>			Systems; // System and priority; the priority only orders systems that are not ordered by constraints
+	std::vector<std::pair<MEngine::SystemID, MEngine::SystemID>>	Orderings; // The first system runs before the second
+	std::vector<uint32_t>										SimulationStepDividers; // Parallel to Systems
+	ExecutionPlan	Plan;
+	bool			IsPlanDirty = true;
+
+	std::vector<MEngine::JobID>	PreparationJobs; // One per prepared system; empty when the game mode is not being prepared
+	MEngine::WorldID			PreparationWorld; // Made active when the game mode is
+};
+
+typedef std::vector<GameMode> GameModeList;
+
+struct SystemTimings
+{
+	SystemTimings() : Presentation(SYSTEM_STATISTICS_SAMPLE_COUNT), Simulation(SYSTEM_STATISTICS_SAMPLE_COUNT) {}
+
+	MEngine::SampleBuffer	Presentation; // Milliseconds
+	MEngine::SampleBuffer	Simulation;
+	float					BudgetMilliseconds = 0.0f;
+};
+
+enum class SystemLayer
+{
+	Presentation,
+	Simulation,
+};
 
 void ChangeToRequestedGameMode();
+void FinishGameModePreparation(GameMode& gameMode);
+void CompileExecutionPlan(GameMode& gameMode);
+void AssignSimulationStepOffsets(ExecutionPlan& plan);
+bool IsSimulationStepDue(const ExecutionPlanEntry& entry, float stepTime, float& outSystemTime);
+const ExecutionPlan& GetExecutionPlan(MEngine::GameModeID gameModeID);
+int32_t FindSystemInGameMode(const GameMode& gameMode, MEngine::SystemID systemID);
+void ClearComponentEvents();
+void DistributeComponentEvents();
+void AddComponentEvent(MEngine::ComponentEvents& events, MEngine::EntityID ID, MEngine::ComponentMask componentTypes, MEngine::ComponentEventType type);
+void SwapSimulationComponentEvents(const ExecutionPlan& plan);
+void RunSimulationSteps(const ExecutionPlan& plan, float elapsedTime, bool onSimulationThread);
+void RunSimulationThread();
+void StartSimulationThread();
+void StopSimulationThread();
 void HandleSuspendResumeRequests();
+void UpdateObservedComponentTypes();
+bool ShouldUpdateSystem(MEngine::System* system);
+bool SystemsConflict(const MEngine::System* lhs, const MEngine::System* rhs);
+void UpdateSystem(MEngine::System* system, SystemLayer layer, float time);
+void RecordSystemTime(MEngine::SystemID ID, SystemLayer layer, uint64_t elapsedTicks);
+void FillTimeStatistics(const MEngine::SampleBuffer& samples, MEngine::SystemTimeStatistics& outStatistics);
+bool ExecuteSystemStatsCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse);
+bool ExecuteFrameStatsCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse);
+void UpdateSystems(const ExecutionPlan& plan, SystemLayer layer, float time);
+void UpdateTimeSlices(const ExecutionPlan& plan);
 void RegisterInternalSystem(MEngine::System* system, uint32_t priority);
 void RegisterInternalSystems();
 
-bool CompareSystemPriorities(const std::pair<MEngine::SystemID, uint32_t>& lhs, const std::pair<MEngine::SystemID, uint32_t>& rhs)
-{
-	return lhs.second < rhs.second;
-};
-
 // TODODB: Make sure that the external application can not manipulate(Add, remove, suspend, resume etc) internal systems
 
 using namespace MEngine;
@@ -38,19 +122,46 @@ namespace MEngineSystemManager
 	MEngine::GameModeID						m_ActiveGameModeID;
 	MEngine::GameModeID						m_RequestedGameModeID;
 
-	std::vector<MEngine::System*>*		m_Systems;
+	std::vector<MEngine::System*>*		m_Systems; // Indexed by system ID; nullptr for unregistered IDs
 	MUtility::MUtilityIDBank<SystemID>*	m_SystemIDBank;
 
 	std::vector<std::pair<SystemID, bool>>* m_SuspendResumeRequests;
 
+	std::vector<MEngine::ComponentEvent>*	m_ComponentEventsScratch; // Collected events waiting to be distributed to the systems
+	std::vector<MEngine::ComponentEvent>*	m_CollectedComponentEvents;
+	MEngine::WorldID						m_LastUpdatedWorldID;
+
+	std::vector<MEngine::JobID>*			m_SystemJobs; // The job updating each system of the active game mode; invalid for systems updated on the main thread
+	std::vector<MEngine::JobID>*			m_SystemJobDependencies;
+
+	std::vector<SystemTimings>*				m_SystemTimings; // Indexed by system ID
+	std::mutex								m_SystemTimingsLock;
+	std::atomic<bool>						m_SystemStatisticsEnabled = false;
+	MEngine::SystemBudgetExceededCallback*	m_SystemBudgetExceededCallback;
+	uint64_t								m_PerformanceFrequency;
+
 	std::vector<SystemID>* m_InternalSystemList;
 	std::vector<uint32_t>* m_InternalSystemPriorities;
 
 	MEngine::FrameCounter	m_PresentationFrameCounter;
 	MEngine::FrameCounter	m_SimulationFrameCounter;
-	float					m_AccumulatedSimulationTime	= 0.0f;
-	float					m_SimulationSpeed			= DEFAULT_SIMULATION_SPEED;
-	float					m_SimulationTimeStep		= DEFAULT_TIME_STEP;
+	float					m_AccumulatedSimulationTime		= 0.0f;
+	float					m_SimulationSpeed				= DEFAULT_SIMULATION_SPEED; // Real time in seconds between simulation steps
+	float					m_SimulationTimeStep			= DEFAULT_TIME_STEP; // Time passed to each simulation step
+	uint32_t				m_MaxSimulationStepsPerFrame	= DEFAULT_MAX_SIMULATION_STEPS_PER_FRAME;
+	uint32_t				m_SimulationStepsLastFrame		= 0;
+	double					m_DroppedSimulationTime			= 0.0;
+	bool					m_UnthrottledSimulation			= false;
+	uint64_t				m_SimulationStepCount			= 0;
+	std::atomic<uint64_t>	m_LastSimulationStepTime		= 0;
+
+	std::thread*							m_SimulationThread				= nullptr;
+	std::mutex								m_SimulationLock; // Held by the simulation thread during its steps and by the main thread during its frame update
+	std::atomic<bool>						m_SimulationThreadRunning		= false;
+	std::atomic<bool>						m_StopSimulationThread			= false;
+	bool									m_SimulationThreadRequested		= false;
+	std::vector<MEngine::ComponentEvents>*	m_SimulationComponentEvents; // Indexed by system ID; the events waiting for the simulation layer while it runs on its own thread
+	std::vector<uint32_t>*					m_PendingSimulationSteps; // Indexed by system ID; steps passed since the last simulation update of systems with a step divider
 }
 
 // ---------- INTERFACE ----------
@@ -71,7 +182,23 @@ SystemID MEngine::RegisterSystem(System* system)
 	if(!isDuplicate)
 	{
 		system->SetID(m_SystemIDBank->GetID());
-		m_Systems->push_back(system);
+		if (m_Systems->size() <= static_cast<size_t>(system->GetID()))
+			m_Systems->resize(system->GetID() + 1, nullptr);
+		(*m_Systems)[system->GetID()] = system;
+
+		std::lock_guard<std::mutex> lock(m_SystemTimingsLock);
+		if (m_SystemTimings->size() <= static_cast<size_t>(system->GetID()))
+			m_SystemTimings->resize(system->GetID() + 1);
+		(*m_SystemTimings)[system->GetID()] = SystemTimings();
+
+		if (m_SimulationComponentEvents->size() <= static_cast<size_t>(system->GetID()))
+			m_SimulationComponentEvents->resize(system->GetID() + 1);
+		(*m_SimulationComponentEvents)[system->GetID()] = ComponentEvents();
+
+		if (m_PendingSimulationSteps->size() <= static_cast<size_t>(system->GetID()))
+			m_PendingSimulationSteps->resize(system->GetID() + 1);
+		(*m_PendingSimulationSteps)[system->GetID()] = 0;
+		UpdateObservedComponentTypes();
 	}
 
 	return system->GetID();
@@ -87,23 +214,56 @@ bool MEngine::UnregisterSystem(SystemID ID)
 	}
 #endif
 
-	bool result = false;
-	for (int i = 0; i < m_Systems->size(); ++i)
+	if (!ID.IsValid() || ID >= static_cast<int32_t>(m_Systems->size()) || (*m_Systems)[ID] == nullptr)
+	{
+		MLOG_WARNING("Attempted to unregister a non-registered system; ID = " << ID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	UnregisterSystemCommands(ID);
+	CancelSystemTimers(ID);
+
+	// The ID will be handed out again, so nothing may keep referring to it
+	for (int i = 0; i < m_GameModes->size(); ++i)
 	{
-		if ((*m_Systems)[i]->GetID() == ID)
+		GameMode& gameMode = (*m_GameModes)[i];
+		int32_t systemIndex = FindSystemInGameMode(gameMode, ID);
+		if (systemIndex >= 0)
 		{
-			UnregisterSystemCommands(ID);
-			m_SystemIDBank->ReturnID(ID);
-			m_Systems->erase(m_Systems->begin() + i);
-			result = true;
-			break;
+			if (!gameMode.PreparationJobs.empty()) // The preparation jobs call into the system, which the caller may delete once it is unregistered
+				FinishGameModePreparation(gameMode);
+
+			gameMode.Systems.erase(gameMode.Systems.begin() + systemIndex);
+			gameMode.SimulationStepDividers.erase(gameMode.SimulationStepDividers.begin() + systemIndex);
+		}
+
+		for (int j = static_cast<int>(gameMode.Orderings.size()) - 1; j >= 0; --j)
+		{
+			if (gameMode.Orderings[j].first == ID || gameMode.Orderings[j].second == ID)
+				gameMode.Orderings.erase(gameMode.Orderings.begin() + j);
 		}
+		gameMode.IsPlanDirty = true; // The plans point to the systems directly
 	}
 
-	if(!result)
-		MLOG_WARNING("Attempted to unregister a non-registered system; ID = " << ID, LOG_CATEGORY_SYSTEM_MANAGER);
+	for (int i = static_cast<int>(m_SuspendResumeRequests->size()) - 1; i >= 0; --i)
+	{
+		if ((*m_SuspendResumeRequests)[i].first == ID)
+			m_SuspendResumeRequests->erase(m_SuspendResumeRequests->begin() + i);
+	}
+
+	for (int i = static_cast<int>(m_InternalSystemList->size()) - 1; i >= 0; --i)
+	{
+		if ((*m_InternalSystemList)[i] == ID)
+		{
+			m_InternalSystemList->erase(m_InternalSystemList->begin() + i);
+			m_InternalSystemPriorities->erase(m_InternalSystemPriorities->begin() + i);
+		}
+	}
 
-	return result;
+	(*m_Systems)[ID] = nullptr;
+	m_SystemIDBank->ReturnID(ID);
+	UpdateObservedComponentTypes();
+	return true;
 }
 
 void MEngine::RequestSuspendSystem(SystemID ID)
@@ -147,21 +307,21 @@ GameModeID MEngine::CreateGameMode()
 {
 	GameModeID gameModeID = m_GameModeIDBank->GetID();
 	if (m_GameModeIDBank->IsIDHighest(gameModeID))
-		m_GameModes->emplace_back(GameModeSystemList());
+		m_GameModes->emplace_back(GameMode());
 	else
-		m_GameModes->emplace(m_GameModes->begin() + gameModeID, GameModeSystemList());
+		m_GameModes->emplace(m_GameModes->begin() + gameModeID, GameMode());
 
 	for (int i = 0; i < m_InternalSystemList->size(); ++i)
 	{
-		(*m_GameModes)[gameModeID].emplace_back(std::make_pair((*m_InternalSystemList)[i], (*m_InternalSystemPriorities)[i]));
+		(*m_GameModes)[gameModeID].Systems.emplace_back(std::make_pair((*m_InternalSystemList)[i], (*m_InternalSystemPriorities)[i]));
+		(*m_GameModes)[gameModeID].SimulationStepDividers.push_back(1);
 	}
-	std::sort((*m_GameModes)[gameModeID].begin(), (*m_GameModes)[gameModeID].end(), CompareSystemPriorities);
 
 	return gameModeID;
 }
 
 // TODODB: Make it possible for a system to start suspended or not suspended in different game modes
-bool MEngine::AddSystemToGameMode(GameModeID gameModeID, SystemID systemID, uint32_t priority) // TODODB: Add shutdown and startup priorities (could be implemented as a priorities struct that is used to sort systems before shutdown and startup)
+bool MEngine::AddSystemToGameMode(GameModeID gameModeID, SystemID systemID, uint32_t priority, uint32_t simulationStepDivider) // TODODB: Add shutdown and startup priorities (could be implemented as a priorities struct that is used to sort systems before shutdown and startup)
 {
 	uint32_t shiftedPriority = priority + MENGINE_MIN_SYSTEM_PRIORITY;
 #if COMPILE_MODE == COMPILE_MODE_DEBUG
@@ -182,27 +342,67 @@ bool MEngine::AddSystemToGameMode(GameModeID gameModeID, SystemID systemID, uint
 		MLOG_WARNING("Attempted to add a system using a priorty that is outside of the allowed scope; Min = " << MENGINE_MIN_SYSTEM_PRIORITY << " max = " << MENGINE_MAX_SYSTEM_PRIORITY, LOG_CATEGORY_SYSTEM_MANAGER);
 		return false;
 	}
+#endif
 
-	const GameModeSystemList& systems = (*m_GameModes)[gameModeID];
-	for (int i = 0; i < systems.size(); ++i)
+	if (simulationStepDivider == 0)
 	{
-		if (systems[i].first == systemID && systems[i].second == shiftedPriority)
-		{
-			MLOG_WARNING("Attempted to add the same system to game mode " << gameModeID <<" more than once using the same priority; system ID = " << systemID << "; priority = " << priority, LOG_CATEGORY_SYSTEM_MANAGER);
-			return false;
-		}
+		MLOG_WARNING("Attempted to add a system to game mode " << gameModeID << " using a simulation step divider of 0; system ID = " << systemID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
 
-		if (systems[i].second == shiftedPriority)
-		{
-			MLOG_WARNING("Priority collision detected when adding system with ID " << systemID << " to game mode with ID " << gameModeID << "; colliding system ID = " << systems[i].first << "; the system will not be added", LOG_CATEGORY_SYSTEM_MANAGER);
-			return false;
-		}
+	GameMode& gameMode = (*m_GameModes)[gameModeID];
+	if (FindSystemInGameMode(gameMode, systemID) >= 0)
+	{
+		MLOG_WARNING("Attempted to add the same system to game mode " << gameModeID << " more than once; system ID = " << systemID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
 	}
-#endif
 
 	// TODODB: Make sure that it's safe to add game modes to the active game mode while running the updates for the game mode's systems
-	(*m_GameModes)[gameModeID].emplace_back(std::make_pair(systemID, shiftedPriority));
-	std::sort((*m_GameModes)[gameModeID].begin(), (*m_GameModes)[gameModeID].end(), CompareSystemPriorities);
+	gameMode.Systems.emplace_back(std::make_pair(systemID, shiftedPriority));
+	gameMode.SimulationStepDividers.push_back(simulationStepDivider);
+	gameMode.IsPlanDirty = true;
+
+	return true;
+}
+
+uint32_t MEngine::CalcSimulationStepDivider(float updatesPerSecond)
+{
+	if (updatesPerSecond <= 0.0f)
+		return 1;
+
+	return std::max(1U, static_cast<uint32_t>(std::lround(1.0f / (updatesPerSecond * m_SimulationSpeed))));
+}
+
+bool MEngine::AddSystemRunsAfter(GameModeID gameModeID, SystemID systemID, SystemID runsAfterSystemID)
+{
+	return AddSystemRunsBefore(gameModeID, runsAfterSystemID, systemID);
+}
+
+bool MEngine::AddSystemRunsBefore(GameModeID gameModeID, SystemID systemID, SystemID runsBeforeSystemID)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (!m_GameModeIDBank->IsIDActive(gameModeID))
+	{
+		MLOG_WARNING("Attempted to add a system ordering to non existent game mode; Game mode ID = " << gameModeID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+#endif
+
+	GameMode& gameMode = (*m_GameModes)[gameModeID];
+	if (FindSystemInGameMode(gameMode, systemID) < 0 || FindSystemInGameMode(gameMode, runsBeforeSystemID) < 0)
+	{
+		MLOG_WARNING("Attempted to order systems that have not been added to game mode " << gameModeID << "; system IDs = " << systemID << ", " << runsBeforeSystemID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	if (systemID == runsBeforeSystemID)
+	{
+		MLOG_WARNING("Attempted to order a system relative to itself; system ID = " << systemID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	gameMode.Orderings.emplace_back(std::make_pair(systemID, runsBeforeSystemID));
+	gameMode.IsPlanDirty = true; // Cycles are detected when the plan is compiled
 
 	return true;
 }
@@ -222,6 +422,247 @@ bool MEngine::RequestGameModeChange(GameModeID newGameModeID)
 	return true;
 }
 
+bool MEngine::PrepareGameMode(GameModeID gameModeID, WorldID preparationWorldID)
+{
+	if (!m_GameModeIDBank->IsIDActive(gameModeID))
+	{
+		MLOG_WARNING("Attempted to prepare a non existent game mode; game mode ID = " << gameModeID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	if (gameModeID == m_ActiveGameModeID)
+	{
+		MLOG_WARNING("Attempted to prepare the already active game mode; game mode ID = " << gameModeID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	if (preparationWorldID.IsValid() && (!IsWorldIDValid(preparationWorldID) || preparationWorldID == GetActiveWorld()))
+	{
+		MLOG_WARNING("Attempted to prepare game mode " << gameModeID << " in an invalid world or the active world; world ID = " << preparationWorldID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	GameMode& gameMode = (*m_GameModes)[gameModeID];
+	if (!gameMode.PreparationJobs.empty())
+	{
+		MLOG_WARNING("Attempted to prepare game mode " << gameModeID << " while it is already being prepared", LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	// Systems that are running in the active game mode can not be prepared without racing their updates
+	gameMode.PreparationWorld = preparationWorldID;
+	const ExecutionPlan& plan = GetExecutionPlan(gameModeID); // Compiling the plan now also takes it off the switch
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		System* system = plan.Entries[i].System;
+		if (m_ActiveGameModeID.IsValid() && IsSystemInGameMode(system->GetID(), m_ActiveGameModeID))
+			continue;
+
+		gameMode.PreparationJobs.push_back(ScheduleJob([system, preparationWorldID]()
+		{
+			const WorldID previousThreadWorld = MEngineWorld::GetThreadWorldOverride();
+			if (preparationWorldID.IsValid())
+				SetThreadWorld(preparationWorldID);
+
+			system->Prepare();
+
+			if (preparationWorldID.IsValid())
+				SetThreadWorld(previousThreadWorld);
+		}));
+	}
+	return true;
+}
+
+float MEngine::GetGameModePreparationProgress(GameModeID gameModeID)
+{
+	if (!m_GameModeIDBank->IsIDActive(gameModeID))
+		return 0.0f;
+
+	const GameMode& gameMode = (*m_GameModes)[gameModeID];
+	if (gameMode.PreparationJobs.empty())
+		return 1.0f;
+
+	uint32_t finishedCount = 0;
+	for (int i = 0; i < gameMode.PreparationJobs.size(); ++i)
+	{
+		if (IsJobFinished(gameMode.PreparationJobs[i]))
+			++finishedCount;
+	}
+	return static_cast<float>(finishedCount) / gameMode.PreparationJobs.size();
+}
+
+bool MEngine::IsGameModePrepared(GameModeID gameModeID)
+{
+	return GetGameModePreparationProgress(gameModeID) >= 1.0f;
+}
+
+void MEngine::SetSystemStatisticsEnabled(bool enabled)
+{
+	m_SystemStatisticsEnabled = enabled;
+}
+
+bool MEngine::IsSystemStatisticsEnabled()
+{
+	return m_SystemStatisticsEnabled;
+}
+
+bool MEngine::GetSystemStatistics(SystemID ID, SystemStatistics& outStatistics)
+{
+	if (!m_SystemIDBank->IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to get statistics for system using an invalid system ID; ID = " << ID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_SystemTimingsLock);
+	const SystemTimings& timings = (*m_SystemTimings)[ID];
+	FillTimeStatistics(timings.Presentation, outStatistics.Presentation);
+	FillTimeStatistics(timings.Simulation, outStatistics.Simulation);
+	return true;
+}
+
+void MEngine::ResetSystemStatistics()
+{
+	std::lock_guard<std::mutex> lock(m_SystemTimingsLock);
+	for (int i = 0; i < m_SystemTimings->size(); ++i)
+	{
+		(*m_SystemTimings)[i].Presentation.Clear();
+		(*m_SystemTimings)[i].Simulation.Clear();
+	}
+}
+
+bool MEngine::SetSystemTimeBudget(SystemID ID, float budgetMilliseconds)
+{
+	if (!m_SystemIDBank->IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to set time budget for system using an invalid system ID; ID = " << ID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	if (budgetMilliseconds < 0.0f)
+	{
+		MLOG_WARNING("Attempted to set a negative time budget for system with ID " << ID << "; budget = " << budgetMilliseconds, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_SystemTimingsLock);
+	(*m_SystemTimings)[ID].BudgetMilliseconds = budgetMilliseconds;
+	return true;
+}
+
+bool MEngine::SetSystemTimeSliceBudget(SystemID ID, float budgetMilliseconds)
+{
+	if (!m_SystemIDBank->IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to set time slice budget for system using an invalid system ID; ID = " << ID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	if (budgetMilliseconds < 0.0f)
+	{
+		MLOG_WARNING("Attempted to set a negative time slice budget for system with ID " << ID << "; budget = " << budgetMilliseconds, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	(*m_Systems)[ID]->GetTimeSliceContext().SetBudget(budgetMilliseconds);
+	return true;
+}
+
+bool MEngine::GetSystemBacklog(SystemID ID, SystemBacklog& outBacklog)
+{
+	if (!m_SystemIDBank->IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to get backlog for system using an invalid system ID; ID = " << ID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+
+	const TimeSliceContext& context = (*m_Systems)[ID]->GetTimeSliceContext();
+	outBacklog.IsInProgress				= context.IsInProgress();
+	outBacklog.RemainingWorkCount		= context.GetRemainingWork();
+	outBacklog.SliceCount				= context.GetSliceCount();
+	outBacklog.LastSliceMilliseconds	= context.GetLastSliceMilliseconds();
+	outBacklog.BudgetMilliseconds		= context.GetBudget();
+	return true;
+}
+
+void MEngine::SetSystemBudgetExceededCallback(SystemBudgetExceededCallback callback)
+{
+	*m_SystemBudgetExceededCallback = callback;
+}
+
+void MEngine::SetSimulationThreadEnabled(bool enabled)
+{
+	m_SimulationThreadRequested = enabled;
+}
+
+bool MEngine::IsSimulationThreadEnabled()
+{
+	return m_SimulationThreadRequested;
+}
+
+void MEngine::SetUnthrottledSimulation(bool unthrottled)
+{
+	m_UnthrottledSimulation = unthrottled;
+	m_AccumulatedSimulationTime = 0.0f;
+}
+
+bool MEngine::IsSimulationUnthrottled()
+{
+	return m_UnthrottledSimulation;
+}
+
+void MEngine::SetMaxSimulationStepsPerFrame(uint32_t maxSteps)
+{
+	if (maxSteps == 0)
+	{
+		MLOG_WARNING("Attempted to set the maximum number of simulation steps per frame to 0; at least one step is required", LOG_CATEGORY_SYSTEM_MANAGER);
+		return;
+	}
+
+	m_MaxSimulationStepsPerFrame = maxSteps;
+}
+
+uint32_t MEngine::GetMaxSimulationStepsPerFrame()
+{
+	return m_MaxSimulationStepsPerFrame;
+}
+
+uint32_t MEngine::GetSimulationStepsLastFrame()
+{
+	return m_SimulationStepsLastFrame;
+}
+
+float MEngine::GetDroppedSimulationTime()
+{
+	return static_cast<float>(m_DroppedSimulationTime);
+}
+
+float MEngine::GetSimulationInterpolationAlpha()
+{
+	if (m_SimulationThreadRunning) // The accumulator is only advanced by the simulation thread, so measure from the last step instead
+		return std::min(static_cast<float>((SDL_GetPerformanceCounter() - m_LastSimulationStepTime) / static_cast<double>(m_PerformanceFrequency)) / m_SimulationSpeed, 1.0f);
+
+	return std::min(m_AccumulatedSimulationTime / m_SimulationSpeed, 1.0f);
+}
+
+void MEngine::GetFrameTimeStatistics(FrameTimeStatistics& outStatistics)
+{
+	outStatistics.Last						= static_cast<float>(m_PresentationFrameCounter.GetDeltaTimeNanoseconds() / 1000000.0);
+	outStatistics.P50						= m_PresentationFrameCounter.GetFrameTimePercentile(50.0f);
+	outStatistics.P95						= m_PresentationFrameCounter.GetFrameTimePercentile(95.0f);
+	outStatistics.P99						= m_PresentationFrameCounter.GetFrameTimePercentile(99.0f);
+	outStatistics.Max						= m_PresentationFrameCounter.GetMaxFrameTime();
+	outStatistics.AverageCPUTime			= m_PresentationFrameCounter.GetAverageCPUTime();
+	outStatistics.AveragePresentWaitTime	= m_PresentationFrameCounter.GetAveragePresentWaitTime();
+	outStatistics.OverBudgetFrameCount		= m_PresentationFrameCounter.GetOverBudgetFrameCount();
+	outStatistics.FrameCount				= m_PresentationFrameCounter.GetFrameCount();
+}
+
+void MEngine::SetFrameTimeBudget(float budgetMilliseconds)
+{
+	m_PresentationFrameCounter.SetFrameBudget(budgetMilliseconds);
+}
+
 bool MEngine::IsSystemIDValid(SystemID ID)
 {
 	return m_SystemIDBank->IsIDActive(ID);
@@ -248,17 +689,58 @@ bool MEngine::IsSystemInGameMode(SystemID systemID, GameModeID gameModeID)
 	}
 #endif
 
-	bool result = false;
-	for (int k = 0; k < m_GameModes[gameModeID].size(); ++k)
+	return FindSystemInGameMode((*m_GameModes)[gameModeID], systemID) >= 0;
+}
+
+bool MEngine::CanSystemsOverlap(GameModeID gameModeID, SystemID firstSystemID, SystemID secondSystemID)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (!m_GameModeIDBank->IsIDActive(gameModeID))
+	{
+		MLOG_WARNING("Attempted to check if systems can overlap using an invalid gamemode ID; ID = " << gameModeID, LOG_CATEGORY_SYSTEM_MANAGER);
+		return false;
+	}
+#endif
+
+	const ExecutionPlan& plan = GetExecutionPlan(gameModeID);
+	int32_t firstIndex	= -1;
+	int32_t secondIndex	= -1;
+	for (int i = 0; i < plan.Entries.size(); ++i)
 	{
-		if ((*m_GameModes)[gameModeID][k].first == systemID)
+		if (plan.Entries[i].System->GetID() == firstSystemID)
+			firstIndex = i;
+		else if (plan.Entries[i].System->GetID() == secondSystemID)
+			secondIndex = i;
+	}
+
+	if (firstIndex < 0 || secondIndex < 0)
+		return false;
+
+	if (firstIndex > secondIndex)
+		std::swap(firstIndex, secondIndex);
+
+	// The systems overlap unless the later one waits for the earlier one through a chain of dependencies
+	std::vector<bool> visited(secondIndex + 1, false);
+	std::vector<uint32_t> toVisit = { static_cast<uint32_t>(secondIndex) };
+	while (!toVisit.empty())
+	{
+		const ExecutionPlanEntry& entry = plan.Entries[toVisit.back()];
+		toVisit.pop_back();
+		for (uint32_t i = entry.FirstDependency; i < entry.FirstDependency + entry.DependencyCount; ++i)
 		{
-			result = true;
-			break;
+			uint32_t dependency = plan.Dependencies[i];
+			if (dependency == static_cast<uint32_t>(firstIndex))
+				return false;
+
+			if (dependency > static_cast<uint32_t>(firstIndex) && !visited[dependency])
+			{
+				visited[dependency] = true;
+				toVisit.push_back(dependency);
+			}
 		}
 	}
 
-	return result;
+	return true;
 }
 
 // ---------- INTERNAL ----------
@@ -270,19 +752,40 @@ void MEngineSystemManager::Initialize()
 	m_Systems					= new std::vector<System*>();
 	m_SystemIDBank				= new MUtility::MUtilityIDBank<SystemID>;
 	m_SuspendResumeRequests		= new std::vector<std::pair<SystemID, bool>>();
-	m_InternalSystemList		= new std::vector<SystemID>();
-	m_InternalSystemPriorities	= new std::vector<uint32_t>();
+	m_ComponentEventsScratch	= new std::vector<ComponentEvent>();
+	m_CollectedComponentEvents	= new std::vector<ComponentEvent>();
+	m_SystemJobs				= new std::vector<JobID>();
+	m_SystemJobDependencies		= new std::vector<JobID>();
+	m_SystemTimings					= new std::vector<SystemTimings>();
+	m_SimulationComponentEvents		= new std::vector<ComponentEvents>();
+	m_PendingSimulationSteps		= new std::vector<uint32_t>();
+	m_SystemBudgetExceededCallback	= new SystemBudgetExceededCallback();
+	m_PerformanceFrequency			= SDL_GetPerformanceFrequency();
+	m_InternalSystemList			= new std::vector<SystemID>();
+	m_InternalSystemPriorities		= new std::vector<uint32_t>();
 
 	RegisterInternalSystems();
+
+	RegisterGlobalCommand("framestats", MEngineConsoleCallback(ExecuteFrameStatsCommand), "Prints frame time statistics for the most recent frames");
+	RegisterGlobalCommand("systemstats", MEngineConsoleCallback(ExecuteSystemStatsCommand), "Prints the update times of all systems in the active game mode; \"on\", \"off\" and \"reset\" control the measuring");
 }
 
 void MEngineSystemManager::Shutdown()
 {
+	if (m_SimulationThreadRunning)
+		StopSimulationThread();
+	m_SimulationThreadRequested = false;
+
+	for (int i = 0; i < m_GameModes->size(); ++i)
+	{
+		FinishGameModePreparation((*m_GameModes)[i]); // Preparing systems may not be destroyed under the running jobs
+	}
+
 	// Shut down the currently active systems
-	const GameModeSystemList& gameModeSystems = (*m_GameModes)[m_ActiveGameModeID];
-	for (int i = 0; i < gameModeSystems.size(); ++i)
+	const ExecutionPlan& plan = GetExecutionPlan(m_ActiveGameModeID);
+	for (int i = 0; i < plan.Entries.size(); ++i)
 	{
-		(*m_Systems)[gameModeSystems[i].first]->Shutdown();
+		plan.Entries[i].System->Shutdown();
 	}
 
 	delete m_GameModes;
@@ -304,6 +807,16 @@ void MEngineSystemManager::Shutdown()
 	delete m_SystemIDBank;
 
 	delete m_SuspendResumeRequests;
+	delete m_ComponentEventsScratch;
+	delete m_CollectedComponentEvents;
+	delete m_SystemJobs;
+	delete m_SystemJobDependencies;
+	delete m_SystemTimings;
+	delete m_SimulationComponentEvents;
+	delete m_PendingSimulationSteps;
+	delete m_SystemBudgetExceededCallback;
+	m_SystemStatisticsEnabled = false;
+	MEngineWorld::SetObservedComponentTypes(MUtility::EMPTY_BITSET);
 }
 
 void MEngineSystemManager::Update()
@@ -314,48 +827,120 @@ void MEngineSystemManager::Update()
 	if (m_RequestedGameModeID.IsValid()) // A valid ID indicates that a request has been made
 		ChangeToRequestedGameMode();
 
-	// Update systems
+	DistributeComponentEvents();
+
+	// Update systems; the simulation catches up on the elapsed time first so that the presentation can interpolate towards the next step
 	m_PresentationFrameCounter.Tick();
 	float deltaTime = m_PresentationFrameCounter.GetDeltaTime();
-	const GameModeSystemList& activeSystems = (*m_GameModes)[m_ActiveGameModeID];
-	for(int i = 0; i < activeSystems.size(); ++i)
+	const ExecutionPlan& plan = GetExecutionPlan(m_ActiveGameModeID);
+
+	if (!m_SimulationThreadRunning)
+		RunSimulationSteps(plan, deltaTime, false);
+
+	UpdateSystems(plan, SystemLayer::Presentation, deltaTime);
+	UpdateTimeSlices(plan);
+	MEngineTimers::UpdatePresentationTimers();
+	MEngineTasks::Update();
+
+	ClearComponentEvents();
+	MEngineEventBus::SwapBuffers();
+}
+
+std::unique_lock<std::mutex> MEngineSystemManager::BeginFrame()
+{
+	// Without presenting to a visible window nothing else limits the frame rate (headless or minimized), so sleep until the next simulation step is due
+	if (!WindowIsVisible() && !m_UnthrottledSimulation)
 	{
-		System* system = (*m_Systems)[activeSystems[i].first];
-		if(!system->IsSuspended())
-			system->UpdatePresentationLayer(deltaTime);
+		float timeUntilNextStep = m_SimulationSpeed - m_PresentationFrameCounter.GetTimeSinceTick();
+		if (!m_SimulationThreadRunning)
+			timeUntilNextStep -= m_AccumulatedSimulationTime;
+
+		if (timeUntilNextStep > 0.0f)
+			SDL_Delay(static_cast<uint32_t>(timeUntilNextStep * MILLISECONDS_PER_SECOND));
 	}
 
-	m_AccumulatedSimulationTime += deltaTime;
-	if (m_AccumulatedSimulationTime > m_SimulationSpeed)
-	{
-		m_SimulationFrameCounter.Tick();
-		m_AccumulatedSimulationTime -= m_SimulationSpeed;
+	if (m_SimulationThreadRequested != m_SimulationThreadRunning)
+		m_SimulationThreadRequested ? StartSimulationThread() : StopSimulationThread();
 
-		for (int i = 0; i < activeSystems.size(); ++i)
-		{
-			System* system = (*m_Systems)[activeSystems[i].first];
-			if (!system->IsSuspended())
-				system->UpdateSimulationLayer(m_SimulationTimeStep);
-		}
+	return m_SimulationThreadRunning ? std::unique_lock<std::mutex>(m_SimulationLock) : std::unique_lock<std::mutex>();
+}
+
+bool MEngineSystemManager::IsSimulationThreadRunning()
+{
+	return m_SimulationThreadRunning;
+}
+
+uint64_t MEngineSystemManager::GetSimulationStepCount()
+{
+	return m_SimulationStepCount;
+}
+
+uint64_t MEngineSystemManager::GetLastSimulationStepTime()
+{
+	return m_LastSimulationStepTime;
+}
+
+float MEngineSystemManager::GetSimulationSpeed()
+{
+	return m_SimulationSpeed;
+}
+
+float MEngineSystemManager::GetSimulationTimeStep()
+{
+	return m_SimulationTimeStep;
+}
+
+bool MEngineSystemManager::RequiresContinuousUpdates()
+{
+	if (!m_ActiveGameModeID.IsValid())
+		return false;
+
+	const ExecutionPlan& plan = GetExecutionPlan(m_ActiveGameModeID);
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		System* system = plan.Entries[i].System;
+		if (!system->IsSuspended() && (system->GetSystemSettings() & SystemSettings::CONTINUOUS_UPDATES) != 0)
+			return true;
 	}
+	return false;
+}
+
+void MEngineSystemManager::CollectComponentEvents()
+{
+	m_CollectedComponentEvents->clear();
+	MEngineWorld::GetWorld(GetActiveWorld())->TakeComponentEvents(*m_CollectedComponentEvents);
+	if (m_CollectedComponentEvents->empty())
+		return;
+
+	MEngineGraphics::HandleComponentEvents(*m_CollectedComponentEvents);
+	m_ComponentEventsScratch->insert(m_ComponentEventsScratch->end(), m_CollectedComponentEvents->begin(), m_CollectedComponentEvents->end());
+}
+
+FrameCounter& MEngineSystemManager::GetPresentationFrameCounter()
+{
+	return m_PresentationFrameCounter;
 }
 
 // ---------- LOCAL ----------
 
 void ChangeToRequestedGameMode()
 {
+	GameMode& requestedGameMode = (*m_GameModes)[m_RequestedGameModeID];
+	FinishGameModePreparation(requestedGameMode); // Only blocks if the preparation was requested too late to finish in the background
+
 	// Stop all running systems
 	if (m_ActiveGameModeID.IsValid())
 	{
-		const GameModeSystemList& currentSystems = (*m_GameModes)[m_ActiveGameModeID];
+		const ExecutionPlan& currentPlan = GetExecutionPlan(m_ActiveGameModeID);
 		if (m_ActiveGameModeID.IsValid())
 		{
-			for (int i = 0; i < currentSystems.size(); ++i)
+			for (int i = 0; i < currentPlan.Entries.size(); ++i)
 			{
-				System* system = (*m_Systems)[currentSystems[i].first];
-				if ((system->GetSystemSettings() & SystemSettings::NO_TRANSITION_RESET) == 0 || !IsSystemInGameMode(currentSystems[i].first, m_RequestedGameModeID))
+				System* system = currentPlan.Entries[i].System;
+				if ((system->GetSystemSettings() & SystemSettings::NO_TRANSITION_RESET) == 0 || !IsSystemInGameMode(system->GetID(), m_RequestedGameModeID))
 				{
 					UnregisterSystemCommands(system->GetID());
+					CancelSystemTimers(system->GetID());
 					system->Shutdown();
 				}
 			}
@@ -363,19 +948,394 @@ void ChangeToRequestedGameMode()
 	}
 
 	UnregisterGameModeCommands(m_ActiveGameModeID);
+	if (m_ActiveGameModeID.IsValid())
+		CancelGameModeTimers(m_ActiveGameModeID);
+
+	if (requestedGameMode.PreparationWorld.IsValid()) // Switch to the world built during preparation before the new systems start using it
+	{
+		if (requestedGameMode.PreparationWorld != GetActiveWorld() && RequestWorldChange(requestedGameMode.PreparationWorld))
+			MEngineWorld::Update();
+		requestedGameMode.PreparationWorld.Invalidate();
+	}
 
 	// Start systems for the new game mode
-	const GameModeSystemList& newSystems = (*m_GameModes)[m_RequestedGameModeID];
-	for (int i = 0; i < newSystems.size(); ++i)
+	const ExecutionPlan& newPlan = GetExecutionPlan(m_RequestedGameModeID);
+	for (int i = 0; i < newPlan.Entries.size(); ++i)
 	{
-		System* system = (*m_Systems)[newSystems[i].first];
-		if ((system->GetSystemSettings() & SystemSettings::NO_TRANSITION_RESET) == 0 || !IsSystemInGameMode(newSystems[i].first, m_RequestedGameModeID))
+		System* system = newPlan.Entries[i].System;
+		if ((system->GetSystemSettings() & SystemSettings::NO_TRANSITION_RESET) == 0 || !IsSystemInGameMode(system->GetID(), m_RequestedGameModeID))
+		{
 			system->Initialize();
+			system->GetComponentEvents().Clear();
+			system->GetComponentEvents().FullRescanRequired = true; // Events were not delivered while the system was stopped
+			system->GetTimeSliceContext().Finish(); // Work begun before the system was stopped is abandoned
+		}
 	}
 	m_ActiveGameModeID = m_RequestedGameModeID;
 	m_RequestedGameModeID.Invalidate();
 }
 
+void FinishGameModePreparation(GameMode& gameMode)
+{
+	for (int i = 0; i < gameMode.PreparationJobs.size(); ++i)
+	{
+		WaitForJob(gameMode.PreparationJobs[i]);
+	}
+	gameMode.PreparationJobs.clear();
+}
+
+void CompileExecutionPlan(GameMode& gameMode)
+{
+	const std::vector<std::pair<SystemID, uint32_t>>& systems = gameMode.Systems;
+	const uint32_t systemCount = static_cast<uint32_t>(systems.size());
+
+	std::vector<std::vector<uint32_t>> successors(systemCount);
+	std::vector<uint32_t> predecessorCounts(systemCount, 0);
+	for (int i = 0; i < gameMode.Orderings.size(); ++i)
+	{
+		int32_t first	= FindSystemInGameMode(gameMode, gameMode.Orderings[i].first);
+		int32_t second	= FindSystemInGameMode(gameMode, gameMode.Orderings[i].second);
+		successors[first].push_back(second);
+		++predecessorCounts[second];
+	}
+
+	// Topological sort (Kahn's algorithm) where the ready system with the lowest priority value goes first
+	auto runsLater = [&systems](uint32_t lhs, uint32_t rhs) { return systems[lhs].second != systems[rhs].second ? systems[lhs].second > systems[rhs].second : systems[lhs].first > systems[rhs].first; };
+	std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(runsLater)> readySystems(runsLater);
+	for (uint32_t i = 0; i < systemCount; ++i)
+	{
+		if (predecessorCounts[i] == 0)
+			readySystems.push(i);
+	}
+
+	std::vector<uint32_t> order;
+	order.reserve(systemCount);
+	while (!readySystems.empty())
+	{
+		uint32_t current = readySystems.top();
+		readySystems.pop();
+		order.push_back(current);
+		for (int i = 0; i < successors[current].size(); ++i)
+		{
+			if (--predecessorCounts[successors[current][i]] == 0)
+				readySystems.push(successors[current][i]);
+		}
+	}
+
+	if (order.size() < systemCount)
+	{
+		std::stringstream cycleSystems;
+		for (uint32_t i = 0; i < systemCount; ++i)
+		{
+			if (predecessorCounts[i] > 0)
+				cycleSystems << systems[i].first << " ";
+		}
+		MLOG_ERROR("Cycle detected in the system orderings of a game mode; the orderings will be ignored and the systems will be updated in priority order; systems in or after the cycle = " << cycleSystems.str(), LOG_CATEGORY_SYSTEM_MANAGER);
+
+		order.clear();
+		for (uint32_t i = 0; i < systemCount; ++i)
+		{
+			order.push_back(i);
+			successors[i].clear();
+		}
+		std::sort(order.begin(), order.end(), [&runsLater](uint32_t lhs, uint32_t rhs) { return runsLater(rhs, lhs); });
+	}
+
+	std::vector<uint32_t> positions(systemCount);
+	for (uint32_t i = 0; i < systemCount; ++i)
+	{
+		positions[order[i]] = i;
+	}
+
+	// Propagate the orderings transitively so that a skipped system does not break a chain of orderings
+	std::vector<std::vector<bool>> runsAfter(systemCount, std::vector<bool>(systemCount, false)); // Indexed by plan position; [later][earlier]
+	for (uint32_t i = 0; i < systemCount; ++i)
+	{
+		const std::vector<uint32_t>& currentSuccessors = successors[order[i]];
+		for (int j = 0; j < currentSuccessors.size(); ++j)
+		{
+			std::vector<bool>& successorRunsAfter = runsAfter[positions[currentSuccessors[j]]];
+			successorRunsAfter[i] = true;
+			for (uint32_t k = 0; k < i; ++k)
+			{
+				if (runsAfter[i][k])
+					successorRunsAfter[k] = true;
+			}
+		}
+	}
+
+	ExecutionPlan& plan = gameMode.Plan;
+	plan.Entries.clear();
+	plan.Dependencies.clear();
+	for (uint32_t i = 0; i < systemCount; ++i)
+	{
+		ExecutionPlanEntry entry;
+		entry.System				= (*m_Systems)[systems[order[i]].first];
+		entry.SimulationStepDivider	= gameMode.SimulationStepDividers[order[i]];
+		entry.SimulationStepOffset	= 0;
+		entry.FirstDependency		= static_cast<uint32_t>(plan.Dependencies.size());
+		for (uint32_t j = 0; j < i; ++j)
+		{
+			if (runsAfter[i][j] || SystemsConflict(entry.System, plan.Entries[j].System))
+				plan.Dependencies.push_back(j);
+		}
+		entry.DependencyCount = static_cast<uint32_t>(plan.Dependencies.size()) - entry.FirstDependency;
+		plan.Entries.push_back(entry);
+	}
+	AssignSimulationStepOffsets(plan);
+
+	gameMode.IsPlanDirty = false;
+}
+
+void AssignSimulationStepOffsets(ExecutionPlan& plan)
+{
+	// Two systems with dividers a and b and offsets x and y are updated on the same step at some point if x and y are congruent modulo gcd(a, b).
+	// Give each system the offset that shares steps with the fewest of the systems placed before it.
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		ExecutionPlanEntry& entry = plan.Entries[i];
+		if (entry.SimulationStepDivider <= 1)
+			continue;
+
+		uint32_t bestCollisionCount = std::numeric_limits<uint32_t>::max();
+		for (uint32_t offset = 0; offset < entry.SimulationStepDivider && bestCollisionCount > 0; ++offset)
+		{
+			uint32_t collisionCount = 0;
+			for (int j = 0; j < i; ++j)
+			{
+				const ExecutionPlanEntry& other = plan.Entries[j];
+				uint32_t commonDivisor = std::gcd(entry.SimulationStepDivider, other.SimulationStepDivider);
+				if (other.SimulationStepDivider > 1 && offset % commonDivisor == other.SimulationStepOffset % commonDivisor)
+					++collisionCount;
+			}
+
+			if (collisionCount < bestCollisionCount)
+			{
+				bestCollisionCount = collisionCount;
+				entry.SimulationStepOffset = offset;
+			}
+		}
+	}
+}
+
+bool IsSimulationStepDue(const ExecutionPlanEntry& entry, float stepTime, float& outSystemTime)
+{
+	// Systems updated at a reduced rate receive the time of all steps since their last update; the count is capped so that a system that missed
+	// its updates (e.g. because it had no events) never receives more than one interval at once
+	uint32_t& pendingSteps = (*m_PendingSimulationSteps)[entry.System->GetID()];
+	pendingSteps = std::min(pendingSteps + 1, entry.SimulationStepDivider);
+	if (m_SimulationStepCount % entry.SimulationStepDivider != entry.SimulationStepOffset)
+		return false;
+
+	outSystemTime = stepTime * pendingSteps;
+	return true;
+}
+
+const ExecutionPlan& GetExecutionPlan(GameModeID gameModeID)
+{
+	GameMode& gameMode = (*m_GameModes)[gameModeID];
+	if (gameMode.IsPlanDirty)
+		CompileExecutionPlan(gameMode);
+
+	return gameMode.Plan;
+}
+
+int32_t FindSystemInGameMode(const GameMode& gameMode, SystemID systemID)
+{
+	for (int i = 0; i < gameMode.Systems.size(); ++i)
+	{
+		if (gameMode.Systems[i].first == systemID)
+			return i;
+	}
+	return -1;
+}
+
+void ClearComponentEvents()
+{
+	const ExecutionPlan& plan = GetExecutionPlan(m_ActiveGameModeID);
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		System* system = plan.Entries[i].System;
+		if (!system->IsSuspended()) // Suspended systems keep their events until they are resumed
+			system->GetComponentEvents().Clear();
+	}
+}
+
+void DistributeComponentEvents()
+{
+	CollectComponentEvents();
+
+	bool worldChanged = GetActiveWorld() != m_LastUpdatedWorldID;
+	m_LastUpdatedWorldID = GetActiveWorld();
+
+	const ExecutionPlan& plan = GetExecutionPlan(m_ActiveGameModeID);
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		System* system = plan.Entries[i].System;
+		ComponentMask observedComponentTypes = system->GetObservedComponentTypes();
+		if (observedComponentTypes == MUtility::EMPTY_BITSET)
+			continue;
+
+		ComponentEvents& events = system->GetComponentEvents();
+		ComponentEvents* simulationEvents = m_SimulationThreadRunning ? &(*m_SimulationComponentEvents)[system->GetID()] : nullptr; // The simulation thread gets its own copy of the events
+		if (worldChanged)
+		{
+			events.Clear();
+			events.FullRescanRequired = true;
+			if (simulationEvents != nullptr)
+			{
+				simulationEvents->Clear();
+				simulationEvents->FullRescanRequired = true;
+			}
+			continue;
+		}
+
+		for (int j = 0; j < m_ComponentEventsScratch->size(); ++j)
+		{
+			const ComponentEvent& event = (*m_ComponentEventsScratch)[j];
+			ComponentMask componentTypes = event.ComponentTypes & observedComponentTypes;
+			if (componentTypes == MUtility::EMPTY_BITSET)
+				continue;
+
+			AddComponentEvent(events, event.ID, componentTypes, event.Type);
+			if (simulationEvents != nullptr)
+				AddComponentEvent(*simulationEvents, event.ID, componentTypes, event.Type);
+		}
+	}
+
+	m_ComponentEventsScratch->clear();
+}
+
+void AddComponentEvent(ComponentEvents& events, EntityID ID, ComponentMask componentTypes, ComponentEventType type)
+{
+	switch (type)
+	{
+		case ComponentEventType::Added:
+		{
+			events.Added.emplace_back(ID, componentTypes);
+		} break;
+
+		case ComponentEventType::Removed:
+		{
+			events.Removed.emplace_back(ID, componentTypes);
+		} break;
+
+		case ComponentEventType::Changed:
+		{
+			if (!events.Changed.empty() && events.Changed.back().first == ID) // Merge repeated changes to the same entity
+				events.Changed.back().second |= componentTypes;
+			else
+				events.Changed.emplace_back(ID, componentTypes);
+		} break;
+
+	default:
+		MLOG_ERROR("Received unknown component event type", LOG_CATEGORY_SYSTEM_MANAGER);
+		break;
+	}
+}
+
+void SwapSimulationComponentEvents(const ExecutionPlan& plan)
+{
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		System* system = plan.Entries[i].System;
+		std::swap(system->GetComponentEvents(), (*m_SimulationComponentEvents)[system->GetID()]);
+	}
+}
+
+void RunSimulationSteps(const ExecutionPlan& plan, float elapsedTime, bool onSimulationThread)
+{
+	m_AccumulatedSimulationTime += m_UnthrottledSimulation ? m_SimulationSpeed : elapsedTime;
+	m_SimulationStepsLastFrame = 0;
+
+	bool swappedEvents = onSimulationThread && m_AccumulatedSimulationTime >= m_SimulationSpeed;
+	if (swappedEvents) // Let the simulation layer see the events gathered for it instead of the main thread's
+		SwapSimulationComponentEvents(plan);
+
+	while (m_AccumulatedSimulationTime >= m_SimulationSpeed && m_SimulationStepsLastFrame < m_MaxSimulationStepsPerFrame)
+	{
+		m_SimulationFrameCounter.Tick();
+		m_AccumulatedSimulationTime -= m_SimulationSpeed;
+		++m_SimulationStepsLastFrame;
+
+		UpdateSystems(plan, SystemLayer::Simulation, m_SimulationTimeStep);
+
+		++m_SimulationStepCount;
+		m_LastSimulationStepTime = SDL_GetPerformanceCounter();
+		MEngineTimers::UpdateSimulationTimers(m_SimulationStepCount);
+	}
+
+	if (swappedEvents)
+	{
+		SwapSimulationComponentEvents(plan);
+		for (int i = 0; i < plan.Entries.size(); ++i)
+		{
+			System* system = plan.Entries[i].System;
+			if (!system->IsSuspended()) // Suspended systems keep their events until they are resumed
+				(*m_SimulationComponentEvents)[system->GetID()].Clear();
+		}
+	}
+
+	if (m_AccumulatedSimulationTime >= m_SimulationSpeed) // Drop whole steps that did not fit within the cap but keep the fraction for interpolation
+	{
+		float droppedTime = m_AccumulatedSimulationTime - std::fmod(m_AccumulatedSimulationTime, m_SimulationSpeed);
+		m_AccumulatedSimulationTime -= droppedTime;
+		m_DroppedSimulationTime += droppedTime;
+		if (Settings::HighLogLevel)
+			MLOG_WARNING("Simulation could not keep up with the frame time; dropped " << droppedTime << " seconds of simulation time after " << m_SimulationStepsLastFrame << " steps", LOG_CATEGORY_SYSTEM_MANAGER);
+	}
+}
+
+void RunSimulationThread()
+{
+	FrameCounter stepClock;
+	stepClock.Tick();
+	float timeUntilNextStep = 0.0f;
+	while (!m_StopSimulationThread)
+	{
+		if (timeUntilNextStep > 0.0f)
+			SDL_Delay(static_cast<uint32_t>(timeUntilNextStep * MILLISECONDS_PER_SECOND));
+
+		std::lock_guard<std::mutex> lock(m_SimulationLock);
+		stepClock.Tick();
+		if (!m_ActiveGameModeID.IsValid())
+		{
+			timeUntilNextStep = m_SimulationSpeed;
+			continue;
+		}
+
+		RunSimulationSteps(GetExecutionPlan(m_ActiveGameModeID), stepClock.GetDeltaTime(), true);
+		if (m_SimulationStepsLastFrame > 0)
+			MEngineGraphics::PublishRenderSnapshot();
+
+		timeUntilNextStep = m_UnthrottledSimulation ? 0.0f : m_SimulationSpeed - m_AccumulatedSimulationTime;
+	}
+}
+
+void StartSimulationThread()
+{
+	for (int i = 0; i < m_SimulationComponentEvents->size(); ++i)
+	{
+		(*m_SimulationComponentEvents)[i].Clear();
+		(*m_SimulationComponentEvents)[i].FullRescanRequired = true; // Earlier events were delivered to the main thread's copy only
+	}
+
+	m_StopSimulationThread		= false;
+	m_SimulationThreadRunning	= true;
+	m_SimulationThread			= new std::thread(RunSimulationThread);
+	MLOG_INFO("Simulation thread started", LOG_CATEGORY_SYSTEM_MANAGER);
+}
+
+void StopSimulationThread()
+{
+	m_StopSimulationThread = true;
+	m_SimulationThread->join();
+	delete m_SimulationThread;
+	m_SimulationThread			= nullptr;
+	m_SimulationThreadRunning	= false;
+	MLOG_INFO("Simulation thread stopped", LOG_CATEGORY_SYSTEM_MANAGER);
+}
+
 void HandleSuspendResumeRequests() // TODODB: Handle removal and readding of commands on suspend/resume
 {
 	for (int i = 0; i < m_SuspendResumeRequests->size(); ++i)
@@ -386,6 +1346,252 @@ void HandleSuspendResumeRequests() // TODODB: Handle removal and readding of com
 	m_SuspendResumeRequests->clear();
 }
 
+void UpdateObservedComponentTypes()
+{
+	ComponentMask observedComponentTypes = MEngineGraphics::RENDERED_COMPONENT_TYPES; // The renderer keeps its render list up to date through component events
+	for (int i = 0; i < m_Systems->size(); ++i)
+	{
+		if ((*m_Systems)[i] != nullptr)
+			observedComponentTypes |= (*m_Systems)[i]->GetObservedComponentTypes();
+	}
+	MEngineWorld::SetObservedComponentTypes(observedComponentTypes);
+}
+
+bool ShouldUpdateSystem(System* system)
+{
+	if (system->IsSuspended())
+		return false;
+
+	return (system->GetSystemSettings() & SystemSettings::REACTIVE_ONLY) == 0 || !system->GetComponentEvents().IsEmpty();
+}
+
+bool SystemsConflict(const System* lhs, const System* rhs)
+{
+	return (lhs->GetWriteComponentTypes() & (rhs->GetReadComponentTypes() | rhs->GetWriteComponentTypes())) != 0 || (rhs->GetWriteComponentTypes() & lhs->GetReadComponentTypes()) != 0;
+}
+
+void UpdateSystem(System* system, SystemLayer layer, float time)
+{
+	bool timed = m_SystemStatisticsEnabled;
+	uint64_t startTime = timed ? SDL_GetPerformanceCounter() : 0;
+
+	if (layer == SystemLayer::Presentation)
+		system->UpdatePresentationLayer(time);
+	else
+		system->UpdateSimulationLayer(time);
+
+	if (timed)
+		RecordSystemTime(system->GetID(), layer, SDL_GetPerformanceCounter() - startTime);
+}
+
+void RecordSystemTime(SystemID ID, SystemLayer layer, uint64_t elapsedTicks) // May be called from several worker threads at once
+{
+	float elapsedMilliseconds = static_cast<float>(elapsedTicks * MILLISECONDS_PER_SECOND / m_PerformanceFrequency);
+	float budgetMilliseconds;
+	{
+		std::lock_guard<std::mutex> lock(m_SystemTimingsLock);
+		SystemTimings& timings = (*m_SystemTimings)[ID];
+		(layer == SystemLayer::Presentation ? timings.Presentation : timings.Simulation).AddSample(elapsedMilliseconds);
+		budgetMilliseconds = timings.BudgetMilliseconds;
+	}
+
+	if (budgetMilliseconds > 0.0f && elapsedMilliseconds > budgetMilliseconds)
+	{
+		if (*m_SystemBudgetExceededCallback)
+			(*m_SystemBudgetExceededCallback)(ID, elapsedMilliseconds, budgetMilliseconds);
+		else
+			MLOG_WARNING("System with ID " << ID << " exceeded its time budget in the " << (layer == SystemLayer::Presentation ? "presentation" : "simulation") << " layer; time = " << elapsedMilliseconds << " ms; budget = " << budgetMilliseconds << " ms", LOG_CATEGORY_SYSTEM_MANAGER);
+	}
+}
+
+void FillTimeStatistics(const SampleBuffer& samples, SystemTimeStatistics& outStatistics)
+{
+	outStatistics.Last			= samples.GetLast();
+	outStatistics.Average		= samples.GetAverage();
+	outStatistics.P95			= samples.GetPercentile(95.0f);
+	outStatistics.P99			= samples.GetPercentile(99.0f);
+	outStatistics.Max			= samples.GetMax();
+	outStatistics.SampleCount	= samples.GetSampleCount();
+}
+
+bool ExecuteSystemStatsCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse)
+{
+	if (parameterCount == 1)
+	{
+		if (parameters[0] == "on" || parameters[0] == "off")
+		{
+			SetSystemStatisticsEnabled(parameters[0] == "on");
+			*outResponse = parameters[0] == "on" ? "System statistics are on" : "System statistics are off";
+		}
+		else if (parameters[0] == "reset")
+		{
+			ResetSystemStatistics();
+			*outResponse = "System statistics were reset";
+		}
+		else
+		{
+			*outResponse = "Unknown parameter \"" + parameters[0] + "\"; use \"on\", \"off\" or \"reset\"";
+			return false;
+		}
+		return true;
+	}
+	else if (parameterCount != 0)
+	{
+		*outResponse = "Wrong number of parameters supplied";
+		return false;
+	}
+
+	if (!m_SystemStatisticsEnabled)
+	{
+		*outResponse = "System statistics are off; use \"systemstats on\" to start measuring";
+		return true;
+	}
+
+	if (!m_ActiveGameModeID.IsValid())
+	{
+		*outResponse = "No game mode is active";
+		return true;
+	}
+
+	// Times are in milliseconds; last / average / p95 / p99 / max
+	std::stringstream response;
+	response << std::fixed << std::setprecision(3);
+	const ExecutionPlan& plan = GetExecutionPlan(m_ActiveGameModeID);
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		SystemID ID = plan.Entries[i].System->GetID();
+		SystemStatistics statistics;
+		GetSystemStatistics(ID, statistics);
+
+		response << "System " << ID << ": presentation " << statistics.Presentation.Last << " / " << statistics.Presentation.Average << " / " << statistics.Presentation.P95 << " / " << statistics.Presentation.P99 << " / " << statistics.Presentation.Max
+			<< "; simulation " << statistics.Simulation.Last << " / " << statistics.Simulation.Average << " / " << statistics.Simulation.P95 << " / " << statistics.Simulation.P99 << " / " << statistics.Simulation.Max;
+
+		float budgetMilliseconds;
+		{
+			std::lock_guard<std::mutex> lock(m_SystemTimingsLock);
+			budgetMilliseconds = (*m_SystemTimings)[ID].BudgetMilliseconds;
+		}
+		if (budgetMilliseconds > 0.0f)
+			response << "; budget " << budgetMilliseconds;
+
+		const TimeSliceContext& timeSlice = plan.Entries[i].System->GetTimeSliceContext();
+		if (timeSlice.IsInProgress())
+			response << "; sliced work remaining " << timeSlice.GetRemainingWork() << " after " << timeSlice.GetSliceCount() << " slices";
+
+		if (i < plan.Entries.size() - 1)
+			response << "\n";
+	}
+	*outResponse = response.str();
+
+	return true;
+}
+
+void UpdateSystems(const ExecutionPlan& plan, SystemLayer layer, float time)
+{
+	// Systems with declared component access are run as jobs that depend on the earlier systems listed as their dependencies in the plan.
+	// Other systems are run on the main thread once everything before them has finished. The world is kept in concurrent access while jobs run.
+	World* world = MEngineWorld::GetWorld(GetActiveWorld());
+	bool inConcurrentAccess = false;
+	m_SystemJobs->clear();
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		const ExecutionPlanEntry& entry = plan.Entries[i];
+		System* system = entry.System;
+		float systemTime = time;
+		bool isDue = layer != SystemLayer::Simulation || entry.SimulationStepDivider <= 1 || system->IsSuspended() || IsSimulationStepDue(entry, time, systemTime);
+		if (!isDue || !ShouldUpdateSystem(system))
+		{
+			m_SystemJobs->push_back(JobID::Invalid());
+			continue;
+		}
+
+		if (layer == SystemLayer::Simulation && entry.SimulationStepDivider > 1)
+			(*m_PendingSimulationSteps)[system->GetID()] = 0;
+
+		if (system->HasDeclaredComponentAccess())
+		{
+			m_SystemJobDependencies->clear();
+			for (uint32_t j = entry.FirstDependency; j < entry.FirstDependency + entry.DependencyCount; ++j)
+			{
+				JobID dependency = (*m_SystemJobs)[plan.Dependencies[j]];
+				if (dependency.IsValid())
+					m_SystemJobDependencies->push_back(dependency);
+			}
+
+			if (!inConcurrentAccess && !world->IsInConcurrentAccess())
+				inConcurrentAccess = world->BeginConcurrentAccess();
+
+			m_SystemJobs->push_back(ScheduleJob([system, layer, systemTime]() { UpdateSystem(system, layer, systemTime); }, m_SystemJobDependencies->data(), static_cast<int32_t>(m_SystemJobDependencies->size())));
+		}
+		else
+		{
+			for (int j = 0; j < m_SystemJobs->size(); ++j)
+			{
+				if ((*m_SystemJobs)[j].IsValid())
+					WaitForJob((*m_SystemJobs)[j]);
+			}
+
+			if (inConcurrentAccess)
+			{
+				world->EndConcurrentAccess();
+				inConcurrentAccess = false;
+			}
+
+			UpdateSystem(system, layer, systemTime);
+			m_SystemJobs->push_back(JobID::Invalid());
+		}
+	}
+
+	for (int i = 0; i < m_SystemJobs->size(); ++i)
+	{
+		if ((*m_SystemJobs)[i].IsValid())
+			WaitForJob((*m_SystemJobs)[i]);
+	}
+
+	if (inConcurrentAccess)
+		world->EndConcurrentAccess();
+}
+
+void UpdateTimeSlices(const ExecutionPlan& plan)
+{
+	// Sliced work runs on the main thread after the presentation layer, one slice per system and frame
+	for (int i = 0; i < plan.Entries.size(); ++i)
+	{
+		System* system = plan.Entries[i].System;
+		TimeSliceContext& context = system->GetTimeSliceContext();
+		if (system->IsSuspended() || !context.IsInProgress())
+			continue;
+
+		context.BeginSlice();
+		system->UpdateTimeSlice(context);
+		context.EndSlice();
+
+		if (context.GetLastSliceMilliseconds() > context.GetBudget() * 2.0f && Settings::HighLogLevel)
+			MLOG_WARNING("Time slice of system with ID " << system->GetID() << " overran its budget; time = " << context.GetLastSliceMilliseconds() << " ms; budget = " << context.GetBudget() << " ms", LOG_CATEGORY_SYSTEM_MANAGER);
+	}
+}
+
+bool ExecuteFrameStatsCommand(const std::string* parameters, int32_t parameterCount, std::string* outResponse)
+{
+	if (parameterCount != 0)
+	{
+		*outResponse = "Wrong number of parameters supplied";
+		return false;
+	}
+
+	FrameTimeStatistics statistics;
+	GetFrameTimeStatistics(statistics);
+
+	std::stringstream response;
+	response << std::fixed << std::setprecision(3);
+	response << "Frame time (ms): last " << statistics.Last << "; p50 " << statistics.P50 << "; p95 " << statistics.P95 << "; p99 " << statistics.P99 << "; max " << statistics.Max << "\n";
+	response << "Average CPU time " << statistics.AverageCPUTime << " ms; average present wait " << statistics.AveragePresentWaitTime << " ms\n";
+	response << statistics.OverBudgetFrameCount << " of " << statistics.FrameCount << " frames over budget";
+	*outResponse = response.str();
+
+	return true;
+}
+
 void RegisterInternalSystem(System* system, uint32_t priority)
 {
 	SystemID ID = RegisterSystem(system);
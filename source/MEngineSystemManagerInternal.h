@@ -1,13 +1,31 @@
 #pragma once
 #include "Interface/MEngineSystemManager.h"
 #include "Interface/MEngineSystem.h"
+#include <mutex>
+
+namespace MEngine
+{
+	class FrameCounter;
+}
 
 namespace MEngineSystemManager
 {
 	constexpr float DEFAULT_TIME_STEP			= MEngine::MENGINE_TIME_STEP_FPS_15;
 	constexpr float DEFAULT_SIMULATION_SPEED	= MEngine::MENGINE_TIME_STEP_FPS_15;
+	constexpr uint32_t DEFAULT_MAX_SIMULATION_STEPS_PER_FRAME = 5;
 
 	void Initialize();
 	void Shutdown();
 	void Update();
+
+	std::unique_lock<std::mutex> BeginFrame(); // Paces headless engines, starts or stops the simulation thread on request and returns a lock that keeps simulation steps out of the world until it is released; the lock owns nothing when simulating on the main thread
+	bool IsSimulationThreadRunning();
+	uint64_t GetSimulationStepCount();
+	uint64_t GetLastSimulationStepTime(); // Performance counter value at the end of the last simulation step
+	float GetSimulationSpeed(); // Real time in seconds between simulation steps
+	float GetSimulationTimeStep(); // Simulation time in seconds that passes with each step
+	bool RequiresContinuousUpdates(); // True when an active system in the current game mode has SystemSettings::CONTINUOUS_UPDATES
+	void CollectComponentEvents(); // Takes the component events recorded by the active world so far; they are passed on to the renderer at once and to the systems at the start of the next frame. Call from the main thread or while holding the simulation lock
+
+	MEngine::FrameCounter& GetPresentationFrameCounter();
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "Interface/MEngineTasks.h"
+#include "Interface/MEngineJobs.h"
+#include "MEngineSystemManagerInternal.h"
+#include "MEngineTasksInternal.h"
+#include <MUtilityLog.h>
+#include <SDL_timer.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define LOG_CATEGORY_TASKS "MEngineTasks"
+
+using namespace MEngine;
+
+namespace MEngineTasks
+{
+	struct Task
+	{
+		TaskFunction	Function;
+		uint32_t		Step		= 0;
+		bool			IsCancelled	= false; // Set when the task cancels itself while running
+	};
+
+	typedef std::pair<uint64_t, int64_t> TaskWakeEntry; // Wake time or simulation step and task ID
+	typedef std::priority_queue<TaskWakeEntry, std::vector<TaskWakeEntry>, std::greater<TaskWakeEntry>> TaskWakeQueue;
+
+	void RunTask(int64_t ID);
+	void WaitForCondition(int64_t ID, const TaskWait& wait);
+
+	std::unordered_map<int64_t, Task>*		m_Tasks				= nullptr;
+	std::vector<int64_t>*					m_NextFrameTasks	= nullptr;
+	std::vector<int64_t>*					m_DueTasks			= nullptr;
+	TaskWakeQueue*							m_TimerTasks		= nullptr; // Cancelled tasks are skipped when they come up
+	TaskWakeQueue*							m_StepTasks			= nullptr;
+	std::vector<std::pair<JobID, int64_t>>*	m_JobTasks			= nullptr;
+	int64_t									m_NextTaskID		= 0;
+	uint64_t								m_PerformanceFrequency;
+
+#if MENGINE_COROUTINE_TASKS
+	constexpr size_t TASK_FRAME_SIZE_CLASS	= 64;
+	constexpr size_t TASK_FRAME_CLASS_COUNT	= 16; // Larger frames are not pooled
+
+	std::vector<void*>* m_FreeTaskFrames = nullptr; // One free list per size class
+#endif
+}
+
+using namespace MEngineTasks;
+
+// ---------- INTERFACE ----------
+
+TaskID MEngine::StartTask(TaskFunction function)
+{
+	if (!function)
+	{
+		MLOG_WARNING("Attempted to start a task without a function", LOG_CATEGORY_TASKS);
+		return TaskID::Invalid();
+	}
+
+	int64_t ID = m_NextTaskID++;
+	Task& task = (*m_Tasks)[ID];
+	task.Function = std::move(function);
+	m_NextFrameTasks->push_back(ID);
+	return TaskID(ID);
+}
+
+bool MEngine::CancelTask(TaskID ID)
+{
+	auto iterator = m_Tasks->find(ID);
+	if (iterator == m_Tasks->end() || iterator->second.IsCancelled)
+		return false;
+
+	if (!iterator->second.Function) // The task is running and is cancelling itself; RunTask removes it once the step returns
+		iterator->second.IsCancelled = true;
+	else
+		m_Tasks->erase(iterator);
+	return true;
+}
+
+bool MEngine::IsTaskRunning(TaskID ID)
+{
+	auto iterator = m_Tasks->find(ID);
+	return iterator != m_Tasks->end() && !iterator->second.IsCancelled;
+}
+
+uint32_t MEngine::GetRunningTaskCount()
+{
+	return static_cast<uint32_t>(m_Tasks->size());
+}
+
+#if MENGINE_COROUTINE_TASKS
+void* MEngine::AllocateTaskFrame(size_t size)
+{
+	size_t sizeClass = (size + TASK_FRAME_SIZE_CLASS - 1) / TASK_FRAME_SIZE_CLASS;
+	if (sizeClass >= TASK_FRAME_CLASS_COUNT)
+		return ::operator new(size);
+
+	std::vector<void*>& freeFrames = m_FreeTaskFrames[sizeClass];
+	if (freeFrames.empty())
+		return ::operator new(sizeClass * TASK_FRAME_SIZE_CLASS);
+
+	void* frame = freeFrames.back();
+	freeFrames.pop_back();
+	return frame;
+}
+
+void MEngine::FreeTaskFrame(void* frame, size_t size)
+{
+	size_t sizeClass = (size + TASK_FRAME_SIZE_CLASS - 1) / TASK_FRAME_SIZE_CLASS;
+	if (sizeClass >= TASK_FRAME_CLASS_COUNT)
+		::operator delete(frame);
+	else
+		m_FreeTaskFrames[sizeClass].push_back(frame);
+}
+#endif
+
+// ---------- INTERNAL ----------
+
+void MEngineTasks::Initialize()
+{
+	m_Tasks					= new std::unordered_map<int64_t, Task>();
+	m_NextFrameTasks		= new std::vector<int64_t>();
+	m_DueTasks				= new std::vector<int64_t>();
+	m_TimerTasks			= new TaskWakeQueue();
+	m_StepTasks				= new TaskWakeQueue();
+	m_JobTasks				= new std::vector<std::pair<JobID, int64_t>>();
+	m_PerformanceFrequency	= SDL_GetPerformanceFrequency();
+#if MENGINE_COROUTINE_TASKS
+	m_FreeTaskFrames		= new std::vector<void*>[TASK_FRAME_CLASS_COUNT];
+#endif
+}
+
+void MEngineTasks::Shutdown()
+{
+	delete m_Tasks; // Destroys the coroutines of unfinished tasks, which returns their frames to the pool
+	delete m_NextFrameTasks;
+	delete m_DueTasks;
+	delete m_TimerTasks;
+	delete m_StepTasks;
+	delete m_JobTasks;
+
+#if MENGINE_COROUTINE_TASKS
+	for (int i = 0; i < TASK_FRAME_CLASS_COUNT; ++i)
+	{
+		for (int j = 0; j < m_FreeTaskFrames[i].size(); ++j)
+		{
+			::operator delete(m_FreeTaskFrames[i][j]);
+		}
+	}
+	delete[] m_FreeTaskFrames;
+#endif
+}
+
+void MEngineTasks::Update()
+{
+	if (m_Tasks->empty())
+		return;
+
+	// Tasks started or waiting for the next frame during this update are run in the next one
+	m_DueTasks->swap(*m_NextFrameTasks);
+
+	uint64_t now = SDL_GetPerformanceCounter();
+	while (!m_TimerTasks->empty() && m_TimerTasks->top().first <= now)
+	{
+		m_DueTasks->push_back(m_TimerTasks->top().second);
+		m_TimerTasks->pop();
+	}
+
+	uint64_t simulationStep = MEngineSystemManager::GetSimulationStepCount();
+	while (!m_StepTasks->empty() && m_StepTasks->top().first <= simulationStep)
+	{
+		m_DueTasks->push_back(m_StepTasks->top().second);
+		m_StepTasks->pop();
+	}
+
+	for (int i = 0; i < m_JobTasks->size();)
+	{
+		if (IsJobFinished((*m_JobTasks)[i].first))
+		{
+			m_DueTasks->push_back((*m_JobTasks)[i].second);
+			(*m_JobTasks)[i] = m_JobTasks->back();
+			m_JobTasks->pop_back();
+		}
+		else
+			++i;
+	}
+
+	for (int i = 0; i < m_DueTasks->size(); ++i)
+	{
+		RunTask((*m_DueTasks)[i]);
+	}
+	m_DueTasks->clear();
+}
+
+bool MEngineTasks::HasPendingFrameTasks()
+{
+	return !m_NextFrameTasks->empty() || !m_JobTasks->empty();
+}
+
+uint32_t MEngineTasks::GetMillisecondsUntilNextTimerTask(uint32_t limit)
+{
+	if (m_TimerTasks->empty())
+		return limit;
+
+	uint64_t now		= SDL_GetPerformanceCounter();
+	uint64_t wakeTime	= m_TimerTasks->top().first;
+	if (wakeTime <= now)
+		return 0;
+
+	uint64_t milliseconds = ((wakeTime - now) * 1000 + m_PerformanceFrequency - 1) / m_PerformanceFrequency; // Rounded up so that the task is due when the wait ends
+	return static_cast<uint32_t>(std::min<uint64_t>(milliseconds, limit));
+}
+
+// ---------- LOCAL ----------
+
+void MEngineTasks::RunTask(int64_t ID)
+{
+	auto iterator = m_Tasks->find(ID);
+	if (iterator == m_Tasks->end()) // Cancelled while waiting
+		return;
+
+	// The function is moved out while it runs so that tasks may start other tasks (rehashing the map) or cancel themselves
+	TaskFunction function = std::move(iterator->second.Function);
+	iterator->second.Function = nullptr;
+	TaskWait wait = function(iterator->second.Step++);
+
+	iterator = m_Tasks->find(ID);
+	if (iterator->second.IsCancelled || wait.Type == TaskWaitType::Done)
+	{
+		m_Tasks->erase(iterator);
+		return;
+	}
+
+	iterator->second.Function = std::move(function);
+	WaitForCondition(ID, wait);
+}
+
+void MEngineTasks::WaitForCondition(int64_t ID, const TaskWait& wait)
+{
+	switch (wait.Type)
+	{
+		case TaskWaitType::NextFrame:
+		{
+			m_NextFrameTasks->push_back(ID);
+		} break;
+
+		case TaskWaitType::Seconds:
+		{
+			uint64_t wakeTime = SDL_GetPerformanceCounter() + static_cast<uint64_t>(std::max(wait.Duration, 0.0f) * m_PerformanceFrequency);
+			m_TimerTasks->push(std::make_pair(wakeTime, ID));
+		} break;
+
+		case TaskWaitType::SimulationSteps:
+		{
+			m_StepTasks->push(std::make_pair(MEngineSystemManager::GetSimulationStepCount() + wait.StepCount, ID));
+		} break;
+
+		case TaskWaitType::Job:
+		{
+			if (wait.Job.IsValid())
+				m_JobTasks->push_back(std::make_pair(wait.Job, ID));
+			else
+			{
+				MLOG_WARNING("Task with ID " << ID << " attempted to wait for an invalid job; the task will continue next frame", LOG_CATEGORY_TASKS);
+				m_NextFrameTasks->push_back(ID);
+			}
+		} break;
+
+		default:
+			break;
+	}
+}
\ No newline at end of file
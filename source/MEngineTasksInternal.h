@@ -0,0 +1,12 @@
+#pragma once
+#include "Interface/MEngineTasks.h"
+
+namespace MEngineTasks
+{
+	void Initialize();
+	void Shutdown();
+	void Update(); // Runs the tasks that are due
+
+	bool HasPendingFrameTasks(); // Tasks waiting for the next frame or for a job need the loop to keep running
+	uint32_t GetMillisecondsUntilNextTimerTask(uint32_t limit); // Returns limit if no task wakes up sooner
+}
\ No newline at end of file
@@ -32,6 +32,12 @@ using namespace MEngineText;
 FontID MEngine::CreateFont_(const std::string& relativeFontPath, int32_t fontSize, const ColorData& textColor)
 {
 	FontID ID;
+	if (MEngineGraphics::GetRenderer() == nullptr)
+	{
+		MLOG_WARNING("Attempted to create font without a renderer; create a window first and note that fonts are unavailable when running headless", LOG_CATEGORY_TEXT);
+		return ID;
+	}
+
 	FC_Font* font = FC_CreateFont();
 	const std::string absolutePath = MEngine::GetExecutablePath() + '/' + relativeFontPath;
 	if (!FC_LoadFont(font, MEngineGraphics::GetRenderer(), absolutePath.c_str(), fontSize, FC_MakeColor(textColor.R, textColor.G, textColor.B, textColor.A), TTF_STYLE_NORMAL))
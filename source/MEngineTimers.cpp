@@ -0,0 +1,302 @@
+#include "Interface/MEngineTimers.h"
+#include "MEngineSystemManagerInternal.h"
+#include "MEngineTimersInternal.h"
+#include "TimingWheel.h"
+#include <MUtilityLog.h>
+#include <SDL_timer.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#define LOG_CATEGORY_TIMERS "MEngineTimers"
+
+using namespace MEngine;
+
+namespace MEngineTimers
+{
+	constexpr double MILLISECONDS_PER_SECOND = 1000.0;
+
+	struct Timer
+	{
+		TimerCallback	Callback;
+		uint64_t		DueTick			= 0;
+		uint64_t		IntervalTicks	= 0; // 0 for timers that fire once
+		SystemID		OwnerSystem;
+		GameModeID		OwnerGameMode;
+		TimerClock		Clock			= TimerClock::Presentation;
+		uint32_t		Generation		= 0; // Increased when the slot is freed so that old IDs stop matching
+		bool			IsActive		= false;
+		bool			IsFiring		= false; // The callback has been moved out while it runs
+	};
+
+	typedef std::pair<uint32_t, uint32_t> DueTimer; // Index and generation
+
+	void FireDueTimers(TimingWheel& wheel, uint64_t tick, std::vector<uint32_t>& dueScratch, std::vector<DueTimer>& firingScratch);
+	void CancelTimerByIndex(uint32_t index);
+	void FreeTimer(uint32_t index);
+	uint64_t GetPresentationTick();
+	TimerID MakeTimerID(uint32_t index, uint32_t generation);
+	Timer* FindTimer(TimerID ID);
+
+	std::vector<Timer>*		m_Timers				= nullptr;
+	std::vector<uint32_t>*	m_FreeTimerIndices		= nullptr;
+	TimingWheel*			m_PresentationWheel		= nullptr; // One tick per millisecond
+	TimingWheel*			m_SimulationWheel		= nullptr; // One tick per simulation step
+	std::vector<uint32_t>*	m_PresentationDueScratch	= nullptr;
+	std::vector<DueTimer>*	m_PresentationFiringScratch	= nullptr;
+	std::vector<uint32_t>*	m_SimulationDueScratch		= nullptr;
+	std::vector<DueTimer>*	m_SimulationFiringScratch	= nullptr;
+	uint32_t				m_ActiveTimerCount		= 0;
+	uint64_t				m_StartTime				= 0;
+	uint64_t				m_PerformanceFrequency	= 0;
+	std::mutex	m_TimersLock; // Timers may be added from the simulation thread while the main thread fires presentation timers; not held while callbacks run
+}
+
+using namespace MEngineTimers;
+
+// ---------- INTERFACE ----------
+
+TimerID MEngine::AddTimer(float delaySeconds, TimerCallback callback, const TimerSettings& settings)
+{
+	if (!callback)
+	{
+		MLOG_WARNING("Attempted to add a timer without a callback", LOG_CATEGORY_TIMERS);
+		return TimerID::Invalid();
+	}
+
+	if (delaySeconds < 0.0f || settings.RepeatInterval < 0.0f)
+	{
+		MLOG_WARNING("Attempted to add a timer with a negative delay or repeat interval; delay = " << delaySeconds << "; interval = " << settings.RepeatInterval, LOG_CATEGORY_TIMERS);
+		return TimerID::Invalid();
+	}
+
+	// Presentation ticks are milliseconds and simulation ticks are steps
+	double secondsPerTick = settings.Clock == TimerClock::Presentation ? 1.0 / MILLISECONDS_PER_SECOND : MEngineSystemManager::GetSimulationTimeStep();
+	uint64_t delayTicks		= static_cast<uint64_t>(std::ceil(delaySeconds / secondsPerTick));
+	uint64_t intervalTicks	= settings.RepeatInterval > 0.0f ? std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(settings.RepeatInterval / secondsPerTick))) : 0;
+
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	uint32_t index;
+	if (!m_FreeTimerIndices->empty())
+	{
+		index = m_FreeTimerIndices->back();
+		m_FreeTimerIndices->pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_Timers->size());
+		m_Timers->emplace_back();
+	}
+
+	TimingWheel& wheel = settings.Clock == TimerClock::Presentation ? *m_PresentationWheel : *m_SimulationWheel;
+	uint64_t now = settings.Clock == TimerClock::Presentation ? GetPresentationTick() : wheel.GetCurrentTick();
+
+	Timer& timer = (*m_Timers)[index];
+	timer.Callback		= std::move(callback);
+	timer.DueTick		= now + delayTicks;
+	timer.IntervalTicks	= intervalTicks;
+	timer.OwnerSystem	= settings.OwnerSystem;
+	timer.OwnerGameMode	= settings.OwnerGameMode;
+	timer.Clock			= settings.Clock;
+	timer.IsActive		= true;
+	timer.IsFiring		= false;
+	wheel.Schedule(index, timer.DueTick);
+	++m_ActiveTimerCount;
+
+	return MakeTimerID(index, timer.Generation);
+}
+
+bool MEngine::CancelTimer(TimerID ID)
+{
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	Timer* timer = FindTimer(ID);
+	if (timer == nullptr)
+		return false;
+
+	CancelTimerByIndex(static_cast<uint32_t>(ID & 0xFFFFFFFF));
+	return true;
+}
+
+bool MEngine::IsTimerActive(TimerID ID)
+{
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	return FindTimer(ID) != nullptr;
+}
+
+void MEngine::CancelSystemTimers(SystemID ID)
+{
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	for (uint32_t i = 0; i < m_Timers->size(); ++i)
+	{
+		const Timer& timer = (*m_Timers)[i];
+		if (timer.IsActive && timer.OwnerSystem.IsValid() && timer.OwnerSystem == ID)
+			CancelTimerByIndex(i);
+	}
+}
+
+void MEngine::CancelGameModeTimers(GameModeID ID)
+{
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	for (uint32_t i = 0; i < m_Timers->size(); ++i)
+	{
+		const Timer& timer = (*m_Timers)[i];
+		if (timer.IsActive && timer.OwnerGameMode.IsValid() && timer.OwnerGameMode == ID)
+			CancelTimerByIndex(i);
+	}
+}
+
+uint32_t MEngine::GetActiveTimerCount()
+{
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	return m_ActiveTimerCount;
+}
+
+// ---------- INTERNAL ----------
+
+void MEngineTimers::Initialize()
+{
+	m_Timers					= new std::vector<Timer>();
+	m_FreeTimerIndices			= new std::vector<uint32_t>();
+	m_PresentationWheel			= new TimingWheel();
+	m_SimulationWheel			= new TimingWheel();
+	m_PresentationDueScratch	= new std::vector<uint32_t>();
+	m_PresentationFiringScratch	= new std::vector<DueTimer>();
+	m_SimulationDueScratch		= new std::vector<uint32_t>();
+	m_SimulationFiringScratch	= new std::vector<DueTimer>();
+	m_ActiveTimerCount			= 0;
+	m_PerformanceFrequency		= SDL_GetPerformanceFrequency();
+	m_StartTime					= SDL_GetPerformanceCounter();
+}
+
+void MEngineTimers::Shutdown()
+{
+	delete m_Timers;
+	delete m_FreeTimerIndices;
+	delete m_PresentationWheel;
+	delete m_SimulationWheel;
+	delete m_PresentationDueScratch;
+	delete m_PresentationFiringScratch;
+	delete m_SimulationDueScratch;
+	delete m_SimulationFiringScratch;
+}
+
+void MEngineTimers::UpdatePresentationTimers()
+{
+	FireDueTimers(*m_PresentationWheel, GetPresentationTick(), *m_PresentationDueScratch, *m_PresentationFiringScratch);
+}
+
+void MEngineTimers::UpdateSimulationTimers(uint64_t simulationStep)
+{
+	FireDueTimers(*m_SimulationWheel, simulationStep, *m_SimulationDueScratch, *m_SimulationFiringScratch);
+}
+
+uint32_t MEngineTimers::GetMillisecondsUntilNextPresentationTimer(uint32_t limit)
+{
+	std::lock_guard<std::mutex> lock(m_TimersLock);
+	if (m_ActiveTimerCount == 0)
+		return limit;
+
+	uint64_t now = GetPresentationTick();
+	uint64_t milliseconds = limit;
+	for (const Timer& timer : *m_Timers)
+	{
+		if (timer.IsActive && timer.Clock == TimerClock::Presentation)
+			milliseconds = std::min(milliseconds, timer.DueTick > now ? timer.DueTick - now : 0);
+	}
+	return static_cast<uint32_t>(milliseconds);
+}
+
+// ---------- LOCAL ----------
+
+void MEngineTimers::FireDueTimers(TimingWheel& wheel, uint64_t tick, std::vector<uint32_t>& dueScratch, std::vector<DueTimer>& firingScratch)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_TimersLock);
+		dueScratch.clear();
+		wheel.Advance(tick, dueScratch);
+
+		// Record the generations now since callbacks may cancel later timers and reuse their slots
+		firingScratch.clear();
+		for (int i = 0; i < dueScratch.size(); ++i)
+		{
+			firingScratch.push_back(std::make_pair(dueScratch[i], (*m_Timers)[dueScratch[i]].Generation));
+		}
+	}
+
+	for (int i = 0; i < firingScratch.size(); ++i)
+	{
+		uint32_t index = firingScratch[i].first;
+		TimerCallback callback;
+		{
+			std::lock_guard<std::mutex> lock(m_TimersLock);
+			Timer& timer = (*m_Timers)[index];
+			if (!timer.IsActive || timer.Generation != firingScratch[i].second)
+				continue;
+
+			callback		= std::move(timer.Callback);
+			timer.IsFiring	= true;
+		}
+
+		callback();
+
+		std::lock_guard<std::mutex> lock(m_TimersLock);
+		Timer& timer = (*m_Timers)[index];
+		timer.IsFiring = false;
+		if (timer.IsActive && timer.IntervalTicks > 0)
+		{
+			timer.Callback	= std::move(callback);
+			timer.DueTick	= std::max(timer.DueTick + timer.IntervalTicks, wheel.GetCurrentTick() + 1); // Keeps the cadence without firing repeatedly to catch up
+			wheel.Schedule(index, timer.DueTick);
+		}
+		else if (timer.IsActive)
+			CancelTimerByIndex(index);
+		else
+			FreeTimer(index); // Cancelled by its own callback
+	}
+}
+
+void MEngineTimers::CancelTimerByIndex(uint32_t index)
+{
+	Timer& timer = (*m_Timers)[index];
+	timer.IsActive = false;
+	--m_ActiveTimerCount;
+
+	if (timer.IsFiring) // Freed once the callback returns
+		return;
+
+	(timer.Clock == TimerClock::Presentation ? m_PresentationWheel : m_SimulationWheel)->Unschedule(index);
+	FreeTimer(index);
+}
+
+void MEngineTimers::FreeTimer(uint32_t index)
+{
+	Timer& timer = (*m_Timers)[index];
+	timer.Callback = nullptr;
+	++timer.Generation;
+	m_FreeTimerIndices->push_back(index);
+}
+
+uint64_t MEngineTimers::GetPresentationTick()
+{
+	return static_cast<uint64_t>((SDL_GetPerformanceCounter() - m_StartTime) * MILLISECONDS_PER_SECOND / m_PerformanceFrequency);
+}
+
+TimerID MEngineTimers::MakeTimerID(uint32_t index, uint32_t generation)
+{
+	return TimerID(static_cast<int64_t>((static_cast<uint64_t>(generation & 0x7FFFFFFF) << 32) | index));
+}
+
+Timer* MEngineTimers::FindTimer(TimerID ID)
+{
+	if (!ID.IsValid())
+		return nullptr;
+
+	uint32_t index = static_cast<uint32_t>(ID & 0xFFFFFFFF);
+	if (index >= m_Timers->size())
+		return nullptr;
+
+	Timer& timer = (*m_Timers)[index];
+	return timer.IsActive && MakeTimerID(index, timer.Generation) == ID ? &timer : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+#include "Interface/MEngineTimers.h"
+
+namespace MEngineTimers
+{
+	void Initialize();
+	void Shutdown();
+
+	void UpdatePresentationTimers(); // Fires the presentation timers that are due at the current time
+	void UpdateSimulationTimers(uint64_t simulationStep); // Fires the simulation timers that are due at the given step count
+
+	uint32_t GetMillisecondsUntilNextPresentationTimer(uint32_t limit); // Returns limit if no presentation timer is due sooner
+}
\ No newline at end of file
@@ -16,6 +16,7 @@ namespace MEngineUtility
 
 	std::atomic<bool>	m_HasFocus = false;
 	std::atomic<bool>	m_IsHovered = false;
+	std::atomic<bool>	m_IsVisible = false;
 }
 
 // ---------- INTERFACE ----------
@@ -45,6 +46,11 @@ bool MEngine::WindowIsHovered()
 	return m_IsHovered;
 }
 
+bool MEngine::WindowIsVisible()
+{
+	return m_IsVisible;
+}
+
 // ---------- INTERNAL ----------
 
 void MEngineUtility::Initialize(const char* applicationName, InitFlags initFlags)
@@ -52,8 +58,7 @@ void MEngineUtility::Initialize(const char* applicationName, InitFlags initFlags
 	m_ApplicationName	= new std::string(applicationName);
 	m_ExecutablePath	= new std::string(MUtility::GetExecutableDirectoryPath());
 	m_InitFlags			= initFlags;
-	m_HasFocus			= SDL_GetWindowFlags(MEngineGraphics::GetWindow()) & SDL_WINDOW_INPUT_FOCUS;
-	m_IsHovered			= SDL_GetWindowFlags(MEngineGraphics::GetWindow()) & SDL_WINDOW_MOUSE_FOCUS;
+	Update();
 }
 
 void MEngineUtility::Shutdown()
@@ -64,6 +69,12 @@ void MEngineUtility::Shutdown()
 
 void MEngineUtility::Update()
 {
-	m_HasFocus	= SDL_GetWindowFlags(MEngineGraphics::GetWindow()) & SDL_WINDOW_INPUT_FOCUS;
-	m_IsHovered	= SDL_GetWindowFlags(MEngineGraphics::GetWindow()) & SDL_WINDOW_MOUSE_FOCUS;
+	SDL_Window* window = MEngineGraphics::GetWindow();
+	if (window == nullptr) // No window has been created yet or the engine is running headless
+		return;
+
+	uint32_t windowFlags = SDL_GetWindowFlags(window);
+	m_HasFocus	= windowFlags & SDL_WINDOW_INPUT_FOCUS;
+	m_IsHovered	= windowFlags & SDL_WINDOW_MOUSE_FOCUS;
+	m_IsVisible	= (windowFlags & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN)) == 0; // SDL2 does not report windows covered by other windows
 }
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "Interface/MEngineWorld.h"
+#include "Interface/MEngineInput.h"
+#include "MEngineConsoleInternal.h"
+#include "MEngineWorldInternal.h"
+#include "MEngineComponentManagerInternal.h"
+#include "World.h"
+#include <MUtilityIDBank.h>
+#include <MUtilityLog.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#define LOG_CATEGORY_WORLD_MANAGER "MEngineWorld"
+
+using namespace MEngine;
+using namespace MEngineWorld;
+
+namespace MEngineWorld
+{
+	void ChangeToRequestedWorld();
+
+	std::vector<World*>*				m_Worlds		= nullptr;
+	MUtility::MUtilityIDBank<WorldID>*	m_WorldIDBank	= nullptr;
+	std::mutex							m_WorldsLock;
+
+	// Written by the main thread at the frame boundary; read from job workers, the simulation thread and whichever thread requests the next world
+	std::atomic<World*>		m_ActiveWorld = nullptr;
+	std::atomic<WorldID>	m_ActiveWorldID;
+	std::atomic<WorldID>	m_RequestedWorldID;
+
+	std::atomic<ComponentMask> m_ObservedComponentTypes = MUtility::EMPTY_BITSET;
+
+	thread_local World*		t_ThreadWorld = nullptr; // Overrides the active world for the owning thread when set
+	thread_local WorldID	t_ThreadWorldID;
+}
+
+// ---------- INTERFACE ----------
+
+WorldID MEngine::CreateWorld()
+{
+	std::lock_guard<std::mutex> lock(m_WorldsLock);
+	WorldID ID = m_WorldIDBank->GetID();
+	World* world = new World();
+	if (ID >= static_cast<int32_t>(m_Worlds->size()))
+		m_Worlds->push_back(world);
+	else
+		(*m_Worlds)[ID] = world;
+
+	return ID;
+}
+
+bool MEngine::DestroyWorld(WorldID ID)
+{
+	std::lock_guard<std::mutex> lock(m_WorldsLock);
+	if (!m_WorldIDBank->IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to destroy world using an inactive world ID; ID = " << ID, LOG_CATEGORY_WORLD_MANAGER);
+		return false;
+	}
+
+	if (ID == m_ActiveWorldID.load() || ID == m_RequestedWorldID.load())
+	{
+		MLOG_WARNING("Attempted to destroy the active or requested world; ID = " << ID, LOG_CATEGORY_WORLD_MANAGER);
+		return false;
+	}
+
+	if (t_ThreadWorldID == ID)
+	{
+		t_ThreadWorld = nullptr;
+		t_ThreadWorldID.Invalidate();
+	}
+
+	delete (*m_Worlds)[ID];
+	(*m_Worlds)[ID] = nullptr;
+	m_WorldIDBank->ReturnID(ID);
+	return true;
+}
+
+bool MEngine::RequestWorldChange(WorldID newWorldID)
+{
+	if (!IsWorldIDValid(newWorldID))
+	{
+		MLOG_WARNING("Attempted to change to a world using an invalid world ID; ID = " << newWorldID, LOG_CATEGORY_WORLD_MANAGER);
+		return false;
+	}
+
+	if (m_ActiveWorldID.load() == newWorldID)
+	{
+		MLOG_WARNING("Attempted to change to the already active world; world ID = " << newWorldID, LOG_CATEGORY_WORLD_MANAGER);
+		return false;
+	}
+
+	m_RequestedWorldID.store(newWorldID);
+	return true;
+}
+
+bool MEngine::SetThreadWorld(WorldID ID)
+{
+	if (!ID.IsValid())
+	{
+		t_ThreadWorld = nullptr;
+		t_ThreadWorldID.Invalidate();
+		return true;
+	}
+
+	World* world = GetWorld(ID);
+	if (world == nullptr)
+	{
+		MLOG_WARNING("Attempted to target a world using an invalid world ID; ID = " << ID, LOG_CATEGORY_WORLD_MANAGER);
+		return false;
+	}
+
+	t_ThreadWorld	= world;
+	t_ThreadWorldID	= ID;
+	return true;
+}
+
+WorldID MEngine::GetActiveWorld()
+{
+	return m_ActiveWorldID.load();
+}
+
+WorldID MEngine::GetThreadWorld()
+{
+	return t_ThreadWorldID.IsValid() ? t_ThreadWorldID : m_ActiveWorldID.load();
+}
+
+bool MEngine::IsWorldIDValid(WorldID ID)
+{
+	return m_WorldIDBank->IsIDActive(ID);
+}
+
+bool MEngine::BeginConcurrentAccess()
+{
+	return GetCurrentWorld()->BeginConcurrentAccess();
+}
+
+bool MEngine::EndConcurrentAccess()
+{
+	return GetCurrentWorld()->EndConcurrentAccess();
+}
+
+bool MEngine::IsInConcurrentAccess()
+{
+	return GetCurrentWorld()->IsInConcurrentAccess();
+}
+
+// ---------- INTERNAL ----------
+
+void MEngineWorld::Initialize()
+{
+	m_Worlds		= new std::vector<World*>();
+	m_WorldIDBank	= new MUtility::MUtilityIDBank<WorldID>();
+
+	const WorldID activeWorldID = CreateWorld();
+	m_ActiveWorldID.store(activeWorldID);
+	m_ActiveWorld	= (*m_Worlds)[activeWorldID];
+	m_ActiveWorld.load()->SetRecordsComponentEvents(true);
+}
+
+void MEngineWorld::Shutdown()
+{
+	for (int i = 0; i < m_Worlds->size(); ++i)
+	{
+		delete (*m_Worlds)[i];
+	}
+	delete m_Worlds;
+	delete m_WorldIDBank;
+
+	m_ActiveWorld = nullptr;
+	m_ActiveWorldID.store(WorldID::Invalid());
+	m_RequestedWorldID.store(WorldID::Invalid());
+}
+
+void MEngineWorld::Update()
+{
+	if (m_RequestedWorldID.load().IsValid()) // A valid ID indicates that a request has been made
+		ChangeToRequestedWorld();
+}
+
+World* MEngineWorld::GetCurrentWorld()
+{
+	return t_ThreadWorld != nullptr ? t_ThreadWorld : m_ActiveWorld.load(std::memory_order_relaxed);
+}
+
+WorldID MEngineWorld::GetThreadWorldOverride()
+{
+	return t_ThreadWorldID;
+}
+
+World* MEngineWorld::GetWorld(WorldID ID)
+{
+	std::lock_guard<std::mutex> lock(m_WorldsLock);
+	return m_WorldIDBank->IsIDActive(ID) ? (*m_Worlds)[ID] : nullptr;
+}
+
+void MEngineWorld::AddComponentTypeToWorlds(ComponentMask componentType)
+{
+	std::lock_guard<std::mutex> lock(m_WorldsLock);
+	for (int i = 0; i < m_Worlds->size(); ++i)
+	{
+		if ((*m_Worlds)[i] != nullptr)
+			MEngineComponentManager::CreateComponentBuffer(*(*m_Worlds)[i], componentType);
+	}
+}
+
+void MEngineWorld::RemoveComponentTypeFromWorlds(ComponentMask componentType)
+{
+	std::lock_guard<std::mutex> lock(m_WorldsLock);
+	for (int i = 0; i < m_Worlds->size(); ++i)
+	{
+		if ((*m_Worlds)[i] != nullptr)
+			(*m_Worlds)[i]->RemoveComponentBuffer(componentType);
+	}
+}
+
+void MEngineWorld::SetObservedComponentTypes(ComponentMask componentTypes)
+{
+	m_ObservedComponentTypes = componentTypes;
+}
+
+ComponentMask MEngineWorld::GetObservedComponentTypes()
+{
+	return m_ObservedComponentTypes.load(std::memory_order_relaxed);
+}
+
+// ---------- LOCAL ----------
+
+void MEngineWorld::ChangeToRequestedWorld()
+{
+	// A request made while the change is in progress is kept for the next frame
+	const WorldID requestedWorldID = m_RequestedWorldID.load();
+	World* newWorld = GetWorld(requestedWorldID);
+	if (newWorld == nullptr)
+	{
+		MLOG_WARNING("The requested world was destroyed before it could be activated; ID = " << requestedWorldID, LOG_CATEGORY_WORLD_MANAGER);
+		WorldID expectedID = requestedWorldID;
+		m_RequestedWorldID.compare_exchange_strong(expectedID, WorldID::Invalid());
+		return;
+	}
+
+	if (m_ActiveWorld.load()->IsInConcurrentAccess() || newWorld->IsInConcurrentAccess())
+	{
+		MLOG_WARNING("Postponing world change since a world involved is in concurrent access; ID = " << requestedWorldID, LOG_CATEGORY_WORLD_MANAGER);
+		return;
+	}
+
+	// Text input references a component in the outgoing world
+	if (IsTextInputActive())
+		StopTextInput();
+
+	MEngineConsole::PreWorldChange();
+
+	m_ActiveWorld.load()->SetRecordsComponentEvents(false);
+	newWorld->SetRecordsComponentEvents(true); // Systems rebuild their state from the new world instead of receiving its history as events
+
+	m_ActiveWorld = newWorld;
+	m_ActiveWorldID.store(requestedWorldID);
+	WorldID expectedID = requestedWorldID;
+	m_RequestedWorldID.compare_exchange_strong(expectedID, WorldID::Invalid());
+
+	MEngineConsole::PostWorldChange();
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include "Interface/MEngineWorld.h"
+#include "Interface/MEngineTypes.h"
+
+namespace MEngine
+{
+	class World;
+}
+
+namespace MEngineWorld
+{
+	void Initialize();
+	void Shutdown();
+	void Update(); // Performs requested world changes; call at a frame boundary
+
+	MEngine::World* GetCurrentWorld(); // The world targeted by the calling thread
+	MEngine::WorldID GetThreadWorldOverride(); // The world set through SetThreadWorld on the calling thread; invalid when the thread targets the active world
+	MEngine::World* GetWorld(MEngine::WorldID ID);
+
+	void AddComponentTypeToWorlds(MEngine::ComponentMask componentType);
+	void RemoveComponentTypeFromWorlds(MEngine::ComponentMask componentType);
+
+	void SetObservedComponentTypes(MEngine::ComponentMask componentTypes); // Component events are only recorded for observed component types and only by the active world
+	MEngine::ComponentMask GetObservedComponentTypes();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "RadixSort.h"
+#include <string.h>
+
+using namespace MEngine;
+
+constexpr uint32_t RADIX_BITS	= 8;
+constexpr uint32_t RADIX_SIZE	= 1 << RADIX_BITS;
+constexpr uint32_t RADIX_MASK	= RADIX_SIZE - 1;
+constexpr uint32_t PASS_COUNT	= 64 / RADIX_BITS;
+
+void MEngine::RadixSort(std::vector<SortKey>& inOutKeys, std::vector<SortKey>& scratch)
+{
+	const size_t keyCount = inOutKeys.size();
+	if (keyCount < 2)
+		return;
+
+	// All histograms are built in a single read of the keys
+	uint32_t histograms[PASS_COUNT][RADIX_SIZE];
+	memset(histograms, 0, sizeof(histograms));
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		uint64_t key = inOutKeys[i].Key;
+		for (uint32_t pass = 0; pass < PASS_COUNT; ++pass)
+		{
+			++histograms[pass][(key >> (pass * RADIX_BITS)) & RADIX_MASK];
+		}
+	}
+
+	scratch.resize(keyCount);
+	SortKey* source			= inOutKeys.data();
+	SortKey* destination	= scratch.data();
+	for (uint32_t pass = 0; pass < PASS_COUNT; ++pass)
+	{
+		uint32_t* histogram = histograms[pass];
+		const uint32_t shift = pass * RADIX_BITS;
+		if (histogram[(source[0].Key >> shift) & RADIX_MASK] == keyCount) // Every key has the same digit
+			continue;
+
+		uint32_t offset = 0;
+		for (uint32_t digit = 0; digit < RADIX_SIZE; ++digit)
+		{
+			uint32_t count = histogram[digit];
+			histogram[digit] = offset;
+			offset += count;
+		}
+
+		for (size_t i = 0; i < keyCount; ++i)
+		{
+			destination[histogram[(source[i].Key >> shift) & RADIX_MASK]++] = source[i];
+		}
+
+		SortKey* swap	= source;
+		source			= destination;
+		destination		= swap;
+	}
+
+	if (source != inOutKeys.data())
+		inOutKeys.swap(scratch);
+}
\ No newline at end of file
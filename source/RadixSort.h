@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace MEngine
+{
+	struct SortKey
+	{
+		uint64_t Key;
+		uint32_t Index; // Where the sorted item is found
+	};
+
+	void RadixSort(std::vector<SortKey>& inOutKeys, std::vector<SortKey>& scratch); // Stable LSD radix sort in ascending key order; passes over digits that all keys share are skipped
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "SampleBuffer.h"
+#include <algorithm>
+
+using namespace MEngine;
+
+SampleBuffer::SampleBuffer(uint32_t capacity) : m_Samples(capacity > 0 ? capacity : 1, 0.0f)
+{
+	Clear();
+}
+
+void SampleBuffer::AddSample(float sample)
+{
+	if (m_SampleCount == m_Samples.size())
+		m_Sum -= m_Samples[m_NextIndex];
+	else
+		++m_SampleCount;
+
+	m_Samples[m_NextIndex] = sample;
+	m_Sum += sample;
+	m_NextIndex = (m_NextIndex + 1) % static_cast<uint32_t>(m_Samples.size());
+}
+
+void SampleBuffer::Clear()
+{
+	m_NextIndex		= 0;
+	m_SampleCount	= 0;
+	m_Sum			= 0.0;
+}
+
+float SampleBuffer::GetLast() const
+{
+	if (m_SampleCount == 0)
+		return 0.0f;
+
+	return m_Samples[(m_NextIndex + static_cast<uint32_t>(m_Samples.size()) - 1) % m_Samples.size()];
+}
+
+float SampleBuffer::GetAverage() const
+{
+	return m_SampleCount > 0 ? static_cast<float>(m_Sum / m_SampleCount) : 0.0f;
+}
+
+float SampleBuffer::GetMax() const
+{
+	if (m_SampleCount == 0)
+		return 0.0f;
+
+	return *std::max_element(m_Samples.begin(), m_Samples.begin() + m_SampleCount);
+}
+
+float SampleBuffer::GetPercentile(float percentile) const
+{
+	if (m_SampleCount == 0)
+		return 0.0f;
+
+	std::vector<float> sortedSamples(m_Samples.begin(), m_Samples.begin() + m_SampleCount);
+	uint32_t index = static_cast<uint32_t>(std::min(std::max(percentile, 0.0f), 100.0f) / 100.0f * (m_SampleCount - 1) + 0.5f);
+	std::nth_element(sortedSamples.begin(), sortedSamples.begin() + index, sortedSamples.end());
+	return sortedSamples[index];
+}
+
+uint32_t SampleBuffer::GetSampleCount() const
+{
+	return m_SampleCount;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace MEngine
+{
+	class SampleBuffer // Keeps the most recent samples in a ring buffer and computes statistics over them
+	{
+	public:
+		SampleBuffer(uint32_t capacity);
+
+		void		AddSample(float sample);
+		void		Clear();
+
+		float		GetLast() const;
+		float		GetAverage() const;
+		float		GetMax() const;
+		float		GetPercentile(float percentile) const; // Percentile in the range [0, 100]; sorts a copy of the samples so avoid calling it every frame
+		uint32_t	GetSampleCount() const;
+
+	private:
+		std::vector<float>	m_Samples;
+		uint32_t			m_NextIndex;
+		uint32_t			m_SampleCount;
+		double				m_Sum;
+	};
+}
\ No newline at end of file
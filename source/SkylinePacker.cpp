@@ -0,0 +1,118 @@
+#include "SkylinePacker.h"
+
+using namespace MEngine;
+
+SkylinePacker::SkylinePacker(int32_t width, int32_t height) : m_Width(width), m_Height(height)
+{
+	Reset();
+}
+
+bool SkylinePacker::Insert(int32_t width, int32_t height, int32_t& outPosX, int32_t& outPosY)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	// Bottom-left rule; ties go to the narrowest segment so that wide gaps are kept for wide rectangles
+	size_t	bestIndex	= m_Segments.size();
+	int32_t	bestBottom	= INT32_MAX;
+	int32_t	bestWidth	= INT32_MAX;
+	for (size_t i = 0; i < m_Segments.size(); ++i)
+	{
+		int32_t posY = FindPosY(i, width, height);
+		if (posY < 0)
+			continue;
+
+		if (posY + height < bestBottom || (posY + height == bestBottom && m_Segments[i].Width < bestWidth))
+		{
+			bestIndex	= i;
+			bestBottom	= posY + height;
+			bestWidth	= m_Segments[i].Width;
+		}
+	}
+
+	if (bestIndex == m_Segments.size())
+		return false;
+
+	const SkylineSegment newSegment = { m_Segments[bestIndex].PosX, bestBottom, width };
+	m_Segments.insert(m_Segments.begin() + bestIndex, newSegment);
+
+	// Cut away the parts of the following segments that are now covered by the new one
+	const int32_t newSegmentEnd = newSegment.PosX + newSegment.Width;
+	for (size_t i = bestIndex + 1; i < m_Segments.size();)
+	{
+		SkylineSegment& segment = m_Segments[i];
+		if (segment.PosX >= newSegmentEnd)
+			break;
+
+		const int32_t coveredWidth = newSegmentEnd - segment.PosX;
+		if (coveredWidth >= segment.Width)
+		{
+			m_Segments.erase(m_Segments.begin() + i);
+			continue;
+		}
+
+		segment.PosX	+= coveredWidth;
+		segment.Width	-= coveredWidth;
+		break;
+	}
+
+	for (size_t i = 0; i + 1 < m_Segments.size();)
+	{
+		if (m_Segments[i].PosY == m_Segments[i + 1].PosY)
+		{
+			m_Segments[i].Width += m_Segments[i + 1].Width;
+			m_Segments.erase(m_Segments.begin() + i + 1);
+		}
+		else
+			++i;
+	}
+
+	outPosX = newSegment.PosX;
+	outPosY = bestBottom - height;
+	m_UsedArea += static_cast<uint64_t>(width) * height;
+	return true;
+}
+
+void SkylinePacker::Reset()
+{
+	m_Segments.clear();
+	m_Segments.push_back({ 0, 0, m_Width });
+	m_UsedArea = 0;
+}
+
+int32_t SkylinePacker::GetWidth() const
+{
+	return m_Width;
+}
+
+int32_t SkylinePacker::GetHeight() const
+{
+	return m_Height;
+}
+
+uint64_t SkylinePacker::GetUsedArea() const
+{
+	return m_UsedArea;
+}
+
+int32_t SkylinePacker::FindPosY(size_t segmentIndex, int32_t width, int32_t height) const
+{
+	if (m_Segments[segmentIndex].PosX + width > m_Width)
+		return -1;
+
+	// The rectangle rests on the highest segment below it
+	int32_t posY			= 0;
+	int32_t remainingWidth	= width;
+	for (size_t i = segmentIndex; remainingWidth > 0; ++i)
+	{
+		if (m_Segments[i].PosY > posY)
+			posY = m_Segments[i].PosY;
+
+		if (posY + height > m_Height)
+			return -1;
+
+		remainingWidth -= m_Segments[i].Width;
+	}
+
+	return posY;
+}
\ No newline at end of file
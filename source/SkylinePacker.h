@@ -0,0 +1,35 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace MEngine
+{
+	class SkylinePacker // Packs rectangles into a fixed size area by keeping the top edge of everything packed so far as a row of horizontal segments
+	{
+	public:
+		SkylinePacker(int32_t width, int32_t height);
+
+		bool Insert(int32_t width, int32_t height, int32_t& outPosX, int32_t& outPosY); // Places the rectangle where its bottom ends up lowest; returns false if it does not fit
+		void Reset(); // Frees the whole area
+
+		int32_t		GetWidth() const;
+		int32_t		GetHeight() const;
+		uint64_t	GetUsedArea() const;
+
+	private:
+		struct SkylineSegment
+		{
+			int32_t PosX;
+			int32_t PosY; // The packed area ends at this row; rows grow downwards
+			int32_t Width;
+		};
+
+		int32_t FindPosY(size_t segmentIndex, int32_t width, int32_t height) const; // Returns -1 if the rectangle does not fit when placed at the start of the segment
+
+		std::vector<SkylineSegment>	m_Segments;
+		int32_t						m_Width;
+		int32_t						m_Height;
+		uint64_t					m_UsedArea = 0;
+	};
+}
\ No newline at end of file
@@ -9,34 +9,44 @@
 
 using namespace MEngine;
 
+TextBoxSystem::TextBoxSystem() : System(SystemSettings::NONE, TEXT_BOX_ENTITY_MASK)
+{
+}
+
 void TextBoxSystem::UpdatePresentationLayer(float deltaTime)
 {
-	std::vector<EntityID> textBoxEntites;
-	GetEntitiesMatchingMask(TEXT_BOX_ENTITY_MASK, textBoxEntites);
+	ApplyComponentEvents(GetComponentEvents(), TEXT_BOX_ENTITY_MASK, m_TextBoxes);
+	const std::vector<EntityID>& textBoxEntites = m_TextBoxes.GetEntities();
 	bool anyTextBoxPressed = false;
 	for (int i = 0; i < textBoxEntites.size(); ++i)
 	{
-		const PosSizeComponent*	posSizeComp	= static_cast<const PosSizeComponent*>(GetComponent(textBoxEntites[i], PosSizeComponent::GetComponentMask()));
-		TextComponent*			textComp	= static_cast<TextComponent*>(GetComponent(textBoxEntites[i], TextComponent::GetComponentMask()));
+		const PosSizeComponent*	posSizeComp	= GetComponent<PosSizeComponent>(textBoxEntites[i]);
+		TextComponent*			textComp	= GetComponent<TextComponent>(textBoxEntites[i]);
 		
 		if (posSizeComp->IsMouseOver())
 		{	
 			if ((textComp->EditFlags & TextBoxFlags::Scrollable) != 0)
 			{
-				PosSizeComponent* posSizeComp = static_cast<PosSizeComponent*>(GetComponent(textBoxEntites[i], PosSizeComponent::GetComponentMask()));
+				PosSizeComponent* posSizeComp = GetComponent<PosSizeComponent>(textBoxEntites[i]);
 				int32_t textHeight = GetTextHeight(textComp->FontID, textComp->Text->c_str());
 				if (textHeight > posSizeComp->Height)
 				{
 					if (ScrolledUp() && textComp->ScrolledLinesCount > 0)
+					{
 						--textComp->ScrolledLinesCount;
+						MarkComponentsChanged<TextComponent>(textBoxEntites[i]);
+					}
 					else if (ScrolledDown() && static_cast<int32_t>(textComp->ScrolledLinesCount) < (static_cast<float>((textHeight - posSizeComp->Height)) / GetLineHeight(textComp->FontID)))
+					{
 						++textComp->ScrolledLinesCount;
+						MarkComponentsChanged<TextComponent>(textBoxEntites[i]);
+					}
 				}
 			}
 
 			if ((textComp->EditFlags & TextBoxFlags::Editable) != 0)
 			{
-				const ButtonComponent* buttonComp = static_cast<const ButtonComponent*>(GetComponent(textBoxEntites[i], ButtonComponent::GetComponentMask()));
+				const ButtonComponent* buttonComp = GetComponent<ButtonComponent>(textBoxEntites[i]);
 				if (buttonComp->IsTriggered)
 				{
 					anyTextBoxPressed = true;
@@ -50,7 +60,7 @@ void TextBoxSystem::UpdatePresentationLayer(float deltaTime)
 	{
 		for (int i = 0; i < textBoxEntites.size(); ++i)
 		{
-			TextComponent* textComp = static_cast<TextComponent*>(GetComponent(textBoxEntites[i], TextComponent::GetComponentMask()));
+			TextComponent* textComp = GetComponent<TextComponent>(textBoxEntites[i]);
 			if (IsInputString(textComp->Text))
 			{
 				textComp->StopEditing(); // TODODB: Fix issue that StopEditing isn't executed for the text box being inactivated when pressing anohter textbox
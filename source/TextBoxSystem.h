@@ -1,7 +1,15 @@
 #pragma once
 #include "Interface/MEngineSystem.h"
+#include "Interface/MEngineTypes.h"
+#include <vector>
 
 class TextBoxSystem : public MEngine::System
 {
+public:
+	TextBoxSystem();
+
+private:
 	void UpdatePresentationLayer(float deltaTime) override;
+
+	MEngine::TrackedEntities m_TextBoxes; // Kept up to date through component events
 };
\ No newline at end of file
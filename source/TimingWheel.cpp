@@ -0,0 +1,130 @@
+#include "TimingWheel.h"
+
+using namespace MEngine;
+
+TimingWheel::TimingWheel() : m_Slots(LEVEL_COUNT * SLOT_COUNT, -1)
+{
+}
+
+void TimingWheel::Schedule(uint32_t node, uint64_t dueTick)
+{
+	if (node >= m_Nodes.size())
+		m_Nodes.resize(node + 1);
+	else if (m_Nodes[node].Slot >= 0)
+		Unschedule(node);
+
+	m_Nodes[node].DueTick = dueTick > m_CurrentTick ? dueTick : m_CurrentTick + 1;
+	Link(node);
+	++m_ScheduledCount;
+}
+
+void TimingWheel::Unschedule(uint32_t node)
+{
+	if (!IsScheduled(node))
+		return;
+
+	Node& unlinked = m_Nodes[node];
+	if (unlinked.Previous >= 0)
+		m_Nodes[unlinked.Previous].Next = unlinked.Next;
+	else
+		m_Slots[unlinked.Slot] = unlinked.Next;
+
+	if (unlinked.Next >= 0)
+		m_Nodes[unlinked.Next].Previous = unlinked.Previous;
+
+	unlinked.Previous	= -1;
+	unlinked.Next		= -1;
+	unlinked.Slot		= -1;
+	--m_ScheduledCount;
+}
+
+bool TimingWheel::IsScheduled(uint32_t node) const
+{
+	return node < m_Nodes.size() && m_Nodes[node].Slot >= 0;
+}
+
+void TimingWheel::Advance(uint64_t tick, std::vector<uint32_t>& outDueNodes)
+{
+	while (m_CurrentTick < tick)
+	{
+		if (m_ScheduledCount == 0) // Nothing can become due so skip the remaining ticks
+		{
+			m_CurrentTick = tick;
+			break;
+		}
+
+		++m_CurrentTick;
+
+		// Move the nodes of the next slot on each higher level down once the level below has gone around
+		for (uint32_t level = 1; level < LEVEL_COUNT && ((m_CurrentTick >> ((level - 1) * SLOT_BITS)) & SLOT_MASK) == 0; ++level)
+		{
+			m_Scratch.clear();
+			TakeSlot(level * SLOT_COUNT + ((m_CurrentTick >> (level * SLOT_BITS)) & SLOT_MASK), m_Scratch);
+			for (uint32_t i = 0; i < m_Scratch.size(); ++i)
+			{
+				Link(m_Scratch[i]);
+				++m_ScheduledCount;
+			}
+		}
+
+		m_Scratch.clear();
+		TakeSlot(m_CurrentTick & SLOT_MASK, m_Scratch);
+		for (uint32_t i = 0; i < m_Scratch.size(); ++i)
+		{
+			uint32_t node = m_Scratch[i];
+			if (m_Nodes[node].DueTick <= m_CurrentTick)
+				outDueNodes.push_back(node);
+			else // Only happens for nodes due later than the last level can represent
+			{
+				Link(node);
+				++m_ScheduledCount;
+			}
+		}
+	}
+}
+
+uint64_t TimingWheel::GetCurrentTick() const
+{
+	return m_CurrentTick;
+}
+
+uint32_t TimingWheel::GetScheduledCount() const
+{
+	return m_ScheduledCount;
+}
+
+void TimingWheel::Link(uint32_t node)
+{
+	Node& linked = m_Nodes[node];
+	uint64_t delta = linked.DueTick - m_CurrentTick;
+
+	uint32_t level = 0;
+	while (level < LEVEL_COUNT - 1 && delta >= (1ULL << ((level + 1) * SLOT_BITS)))
+	{
+		++level;
+	}
+
+	uint64_t slotTick = level == LEVEL_COUNT - 1 && delta >= (1ULL << (LEVEL_COUNT * SLOT_BITS)) ? m_CurrentTick + (1ULL << (LEVEL_COUNT * SLOT_BITS)) - 1 : linked.DueTick;
+	linked.Slot		= static_cast<int32_t>(level * SLOT_COUNT + ((slotTick >> (level * SLOT_BITS)) & SLOT_MASK));
+	linked.Previous	= -1;
+	linked.Next		= m_Slots[linked.Slot];
+	if (linked.Next >= 0)
+		m_Nodes[linked.Next].Previous = static_cast<int32_t>(node);
+	m_Slots[linked.Slot] = static_cast<int32_t>(node);
+}
+
+void TimingWheel::TakeSlot(uint32_t slot, std::vector<uint32_t>& outNodes)
+{
+	int32_t node = m_Slots[slot];
+	m_Slots[slot] = -1;
+	while (node >= 0)
+	{
+		Node& taken = m_Nodes[node];
+		outNodes.push_back(static_cast<uint32_t>(node));
+		node			= taken.Next;
+		taken.Previous	= -1;
+		taken.Next		= -1;
+		taken.Slot		= -1;
+		--m_ScheduledCount;
+	}
+}
\ No newline at end of file
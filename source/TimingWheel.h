@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace MEngine
+{
+	class TimingWheel // Hierarchical timing wheel; scheduling and unscheduling are O(1) and advancing costs O(1) per tick plus the work for due and cascading nodes
+	{
+	public:
+		TimingWheel();
+
+		void		Schedule(uint32_t node, uint64_t dueTick); // Nodes are indices chosen by the caller; a node that is already scheduled is moved; ticks that have passed are due on the next tick
+		void		Unschedule(uint32_t node);
+		bool		IsScheduled(uint32_t node) const;
+		void		Advance(uint64_t tick, std::vector<uint32_t>& outDueNodes); // Appends the nodes that became due, in due order, and unschedules them
+
+		uint64_t	GetCurrentTick() const;
+		uint32_t	GetScheduledCount() const;
+
+	private:
+		static constexpr uint32_t SLOT_BITS		= 6;
+		static constexpr uint32_t SLOT_COUNT	= 1 << SLOT_BITS;
+		static constexpr uint32_t SLOT_MASK		= SLOT_COUNT - 1;
+		static constexpr uint32_t LEVEL_COUNT	= 5; // Covers 2^30 ticks; nodes due later wait at the last level and are rescheduled when it comes around
+
+		struct Node
+		{
+			uint64_t	DueTick;
+			int32_t		Previous	= -1;
+			int32_t		Next		= -1;
+			int32_t		Slot		= -1; // Index into m_Slots; -1 when not scheduled
+		};
+
+		void		Link(uint32_t node);
+		void		TakeSlot(uint32_t slot, std::vector<uint32_t>& outNodes);
+
+		std::vector<Node>		m_Nodes;
+		std::vector<int32_t>	m_Slots; // LEVEL_COUNT * SLOT_COUNT list heads
+		std::vector<uint32_t>	m_Scratch;
+		uint64_t				m_CurrentTick		= 0;
+		uint32_t				m_ScheduledCount	= 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,532 @@
+#include "World.h"
+#include "Interface/MEngineSettings.h"
+#include "MEngineComponentManagerInternal.h"
+#include "MEngineWorldInternal.h"
+#include <MUtilityBitset.h>
+#include <MUtilityIntrinsics.h>
+#include <MUtilityLog.h>
+#include <MUtilityMath.h>
+#include <MUtilityPlatformDefinitions.h>
+
+#define LOG_CATEGORY_WORLD "World"
+
+using namespace MEngine;
+
+World::World()
+{
+	MEngineComponentManager::CreateComponentBuffers(*this);
+}
+
+World::~World()
+{
+	for (int i = 0; i < m_Buffers.size(); ++i)
+	{
+		delete m_Buffers[i];
+	}
+}
+
+EntityID World::CreateEntity() // TODODB: Take component mask and add the components described by the mask
+{
+	if (m_IsInConcurrentAccess)
+	{
+		// The ID bank advances its highest handed out ID outside of its own lock, so concurrent reservations are serialized here
+		std::lock_guard<std::mutex> lock(m_DeferredCommandsLock);
+		EntityID ID = m_EntityIDBank.GetID();
+		m_DeferredCommands.push_back({ DeferredCommandType::CreateEntity, ID, MUtility::EMPTY_BITSET });
+		return ID;
+	}
+
+	EntityID ID = m_EntityIDBank.GetID();
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	AccessGuard accessGuard(*this, true);
+#endif
+
+	m_Entities.push_back(ID);
+	m_ComponentMasks.push_back(MUtility::EMPTY_BITSET);
+	m_ComponentIndices.push_back(std::vector<uint32_t>());
+
+	return ID;
+}
+
+bool World::DestroyEntity(EntityID ID)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (!m_EntityIDBank.IsIDActive(ID))
+	{
+		if(Settings::HighLogLevel)
+			MLOG_WARNING("Attempted to destroy entity using an inactive entity ID; ID = " << ID, LOG_CATEGORY_WORLD);
+
+		return false;
+	}
+#endif
+
+	if (m_IsInConcurrentAccess)
+	{
+		DeferCommand(DeferredCommandType::DestroyEntity, ID, MUtility::EMPTY_BITSET);
+		return true;
+	}
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	AccessGuard accessGuard(*this, true);
+#endif
+
+	int32_t entityIndex = GetEntityIndex(ID);
+	if (entityIndex >= 0)
+	{
+		if (m_Entities[entityIndex] == ID)
+		{
+			RecordComponentEvent(ID, m_ComponentMasks[entityIndex], ComponentEventType::Removed);
+			RemoveComponentsFromEntityByIndex(m_ComponentMasks[entityIndex], entityIndex);
+
+			m_Entities.erase(m_Entities.begin() + entityIndex);
+			m_ComponentMasks.erase(m_ComponentMasks.begin() + entityIndex);
+			m_ComponentIndices.erase(m_ComponentIndices.begin() + entityIndex);
+			m_EntityIDBank.ReturnID(ID);
+			return true;
+		}
+	}
+	return false;
+}
+
+ComponentMask World::AddComponentsToEntity(EntityID ID, ComponentMask componentMask)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (componentMask == MENGINE_INVALID_COMPONENT_MASK)
+	{
+		MLOG_WARNING("Attempted to add component(s) to entity using an invalid component mask; mask = " << MUtility::BitSetToString(componentMask), LOG_CATEGORY_WORLD);
+		return componentMask;
+	}
+	else if (!m_EntityIDBank.IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to add components to an entity that doesn't exist; ID = " << ID, LOG_CATEGORY_WORLD);
+		return componentMask;
+	}
+#endif
+
+	if (m_IsInConcurrentAccess)
+	{
+		DeferCommand(DeferredCommandType::AddComponents, ID, componentMask);
+		return MUtility::EMPTY_BITSET;
+	}
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	AccessGuard accessGuard(*this, true);
+#endif
+
+	RecordComponentEvent(ID, componentMask, ComponentEventType::Added);
+
+	int32_t entityIndex = GetEntityIndex(ID);
+	std::vector<uint32_t>& componentIndices = m_ComponentIndices[entityIndex];
+	while (componentMask != MUtility::EMPTY_BITSET)
+	{
+		ComponentMask singleComponentMask = MUtility::GetHighestSetBit(componentMask);
+		uint32_t bufferIndex = MUtilityMath::FastLog2(singleComponentMask);
+		uint32_t componentIndiceListIndex = CalcComponentIndiceListIndex(m_ComponentMasks[entityIndex], bufferIndex);
+		componentIndices.insert(componentIndices.begin() + componentIndiceListIndex, m_Buffers[bufferIndex]->AllocateComponent(ID));
+		m_ComponentMasks[entityIndex] |= singleComponentMask;
+
+		componentMask &= ~MUtility::GetHighestSetBit(componentMask);
+	}
+
+	return MUtility::EMPTY_BITSET;
+}
+
+ComponentMask World::RemoveComponentsFromEntity(EntityID ID, ComponentMask componentMask)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (componentMask == MENGINE_INVALID_COMPONENT_MASK)
+	{
+		MLOG_WARNING("Attempted to removed component(s) from entity using an invalid component mask; mask = " << MUtility::BitSetToString(componentMask), LOG_CATEGORY_WORLD);
+		return componentMask;
+	}
+	else if (!m_EntityIDBank.IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to remove component(s) from an entity that doesn't exist; ID = " << ID, LOG_CATEGORY_WORLD);
+		return componentMask;
+	}
+#endif
+
+	if (m_IsInConcurrentAccess)
+	{
+		DeferCommand(DeferredCommandType::RemoveComponents, ID, componentMask);
+		return MUtility::EMPTY_BITSET;
+	}
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	AccessGuard accessGuard(*this, true);
+#endif
+
+	int32_t entityIndex = GetEntityIndex(ID);
+	if(entityIndex >= 0)
+	{
+		if (m_Entities[entityIndex] == ID)
+		{
+			ComponentMask failedComponents = RemoveComponentsFromEntityByIndex(componentMask, entityIndex);
+			RecordComponentEvent(ID, componentMask & ~failedComponents, ComponentEventType::Removed);
+			return failedComponents;
+		}
+	}
+
+	return componentMask;
+}
+
+void World::GetEntitiesMatchingMask(ComponentMask componentMask, std::vector<EntityID>& outEntities, MaskMatchMode matchMode) const
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (componentMask == MENGINE_INVALID_COMPONENT_MASK)
+	{
+		MLOG_WARNING("Attempted to get components matching an invalid component mask", LOG_CATEGORY_WORLD);
+		return;
+	}
+
+	AccessGuard accessGuard(*this, false);
+#endif
+
+	for (int i = 0; i < m_Entities.size(); ++i)
+	{
+		ComponentMask currentMask = m_ComponentMasks[i];
+		bool isMatch = false;
+		switch (matchMode)
+		{
+			case MaskMatchMode::Any: // The entity has at least one of the components in the paramter mask
+			{
+				isMatch = ((currentMask & componentMask) != 0);
+			} break;
+
+			case MaskMatchMode::Partial: // The entity has at least all the components in the parameter mask but may also have more components on top of those
+			{
+				isMatch = ((currentMask & componentMask) == componentMask);
+			} break;
+
+			case MaskMatchMode::Exact: // The entity has exaclty the components in the parameter mask and no additional components
+			{
+				isMatch = ((currentMask & componentMask) == componentMask && MUtility::PopCount(componentMask) == MUtility::PopCount(currentMask));
+			} break;
+
+		default:
+			MLOG_ERROR("Received unknown matchMode", LOG_CATEGORY_WORLD);
+			return;
+		}
+
+		if (isMatch)
+			outEntities.push_back(m_Entities[i]);
+	}
+}
+
+Component* World::GetComponent(EntityID ID, ComponentMask componentType) const
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (componentType == MENGINE_INVALID_COMPONENT_MASK)
+	{
+		MLOG_WARNING("Attempted to get component for entity using an invalid component mask; mask = " << MUtility::BitSetToString(componentType), LOG_CATEGORY_WORLD);
+		return nullptr;
+	}
+	else if (!m_EntityIDBank.IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to get component for an entity that doesn't exist; ID = " << ID, LOG_CATEGORY_WORLD);
+		return nullptr;
+	}
+	else if (MUtility::PopCount(componentType) != 1)
+	{
+		MLOG_WARNING("Attempted to get component for an entity using a component mask containing more or less than one component; mask = " << MUtility::BitSetToString(componentType), LOG_CATEGORY_WORLD);
+		return nullptr;
+	}
+#endif
+
+	return GetComponentByBufferIndex(ID, MUtilityMath::FastLog2(componentType));
+}
+
+Component* World::GetComponentByBufferIndex(EntityID ID, uint32_t componentBufferIndex) const
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (componentBufferIndex >= m_Buffers.size() || m_Buffers[componentBufferIndex] == nullptr)
+	{
+		MLOG_WARNING("Attempted to get component for entity using an invalid component buffer index; index = " << componentBufferIndex, LOG_CATEGORY_WORLD);
+		return nullptr;
+	}
+	else if (!m_EntityIDBank.IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to get component for an entity that doesn't exist; ID = " << ID, LOG_CATEGORY_WORLD);
+		return nullptr;
+	}
+
+	AccessGuard accessGuard(*this, false);
+#endif
+
+	int32_t entityIndex = GetEntityIndex(ID);
+	if (entityIndex >= 0)
+	{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+		if ((m_ComponentMasks[entityIndex] & (1ULL << componentBufferIndex)) == 0)
+		{
+			MLOG_WARNING("Attempted to get component of type " << m_Buffers[componentBufferIndex]->ComponentName << " for an entity that lacks that component type; entity component mask = " << MUtility::BitSetToString(m_ComponentMasks[entityIndex]), LOG_CATEGORY_WORLD);
+			return nullptr;
+		}
+#endif
+
+		uint32_t componentIndex = m_ComponentIndices[entityIndex][CalcComponentIndiceListIndex(m_ComponentMasks[entityIndex], componentBufferIndex)];
+		return m_Buffers[componentBufferIndex]->GetComponent(componentIndex);
+	}
+
+	return nullptr;
+}
+
+ComponentMask World::GetComponentMask(EntityID ID) const
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	if (!m_EntityIDBank.IsIDActive(ID))
+	{
+		MLOG_WARNING("Attempted to get component mask from an entity that doesn't exist; ID = " << ID, LOG_CATEGORY_WORLD);
+		return MENGINE_INVALID_COMPONENT_MASK;
+	}
+
+	AccessGuard accessGuard(*this, false);
+#endif
+
+	int32_t entityIndex = GetEntityIndex(ID);
+	return entityIndex >= 0 ? m_ComponentMasks[entityIndex] : MENGINE_INVALID_COMPONENT_MASK; // The entity may still be pending creation during concurrent access
+}
+
+bool World::IsEntityIDValid(EntityID ID) const
+{
+	return m_EntityIDBank.IsIDActive(ID);
+}
+
+void World::UpdateComponentIndex(EntityID ID, ComponentMask componentType, uint32_t newComponentIndex)
+{
+	int32_t entityIndex = GetEntityIndex(ID);
+	if (entityIndex >= 0)
+	{
+		uint32_t componentIndexListIndex = CalcComponentIndiceListIndex(m_ComponentMasks[entityIndex], MUtilityMath::FastLog2(componentType));
+		m_ComponentIndices[entityIndex][componentIndexListIndex] = newComponentIndex;
+	}
+}
+
+void World::AddComponentBuffer(ComponentBuffer* buffer)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	AccessGuard accessGuard(*this, true);
+#endif
+
+	uint32_t bufferIndex = MUtilityMath::FastLog2(buffer->ComponentType);
+	if (bufferIndex >= m_Buffers.size())
+		m_Buffers.resize(bufferIndex + 1, nullptr);
+
+	if (m_Buffers[bufferIndex] != nullptr) // The world may have been created while the component type was being registered
+	{
+		delete buffer;
+		return;
+	}
+
+	m_Buffers[bufferIndex] = buffer;
+}
+
+bool World::RemoveComponentBuffer(ComponentMask componentType)
+{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+	AccessGuard accessGuard(*this, true);
+#endif
+
+	uint32_t bufferIndex = MUtilityMath::FastLog2(componentType);
+	if (bufferIndex >= m_Buffers.size() || m_Buffers[bufferIndex] == nullptr)
+		return false;
+
+	delete m_Buffers[bufferIndex];
+	m_Buffers[bufferIndex] = nullptr;
+	return true;
+}
+
+ComponentBuffer* World::GetComponentBuffer(ComponentMask componentType) const
+{
+	uint32_t bufferIndex = MUtilityMath::FastLog2(componentType);
+	return bufferIndex < m_Buffers.size() ? m_Buffers[bufferIndex] : nullptr;
+}
+
+bool World::BeginConcurrentAccess()
+{
+	if (m_IsInConcurrentAccess)
+	{
+		MLOG_WARNING("Attempted to begin concurrent access to a world that is already in concurrent access", LOG_CATEGORY_WORLD);
+		return false;
+	}
+
+	m_IsInConcurrentAccess = true;
+	return true;
+}
+
+bool World::EndConcurrentAccess()
+{
+	if (!m_IsInConcurrentAccess)
+	{
+		MLOG_WARNING("Attempted to end concurrent access to a world that is not in concurrent access", LOG_CATEGORY_WORLD);
+		return false;
+	}
+
+	m_IsInConcurrentAccess = false;
+	ApplyDeferredCommands();
+	return true;
+}
+
+bool World::IsInConcurrentAccess() const
+{
+	return m_IsInConcurrentAccess;
+}
+
+void World::RecordComponentEvent(EntityID ID, ComponentMask componentTypes, ComponentEventType type)
+{
+	++m_ModificationCount;
+
+	ComponentMask observedComponentTypes = componentTypes & MEngineWorld::GetObservedComponentTypes();
+	if (!m_RecordsComponentEvents || observedComponentTypes == MUtility::EMPTY_BITSET)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_ComponentEventsLock); // Changes may be reported by several threads during concurrent access
+	m_ComponentEvents.push_back({ ID, observedComponentTypes, type });
+}
+
+void World::TakeComponentEvents(std::vector<ComponentEvent>& outEvents)
+{
+	std::lock_guard<std::mutex> lock(m_ComponentEventsLock);
+	outEvents.swap(m_ComponentEvents);
+	m_ComponentEvents.clear();
+}
+
+void World::SetRecordsComponentEvents(bool recordsComponentEvents)
+{
+	std::lock_guard<std::mutex> lock(m_ComponentEventsLock);
+	m_RecordsComponentEvents = recordsComponentEvents;
+	m_ComponentEvents.clear();
+}
+
+uint64_t World::GetModificationCount() const
+{
+	return m_ModificationCount;
+}
+
+// ---------- LOCAL ----------
+
+void World::DeferCommand(DeferredCommandType type, EntityID ID, ComponentMask mask)
+{
+	std::lock_guard<std::mutex> lock(m_DeferredCommandsLock);
+	m_DeferredCommands.push_back({ type, ID, mask });
+}
+
+void World::ApplyDeferredCommands()
+{
+	std::vector<DeferredCommand> commands;
+	m_DeferredCommandsLock.lock();
+	commands.swap(m_DeferredCommands);
+	m_DeferredCommandsLock.unlock();
+
+	for (int i = 0; i < commands.size(); ++i) // Commands are applied in submission order so that entities are created before components are added to them
+	{
+		const DeferredCommand& command = commands[i];
+		switch (command.Type)
+		{
+			case DeferredCommandType::CreateEntity: // The ID was reserved when the command was deferred
+			{
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+				AccessGuard accessGuard(*this, true);
+#endif
+				m_Entities.push_back(command.ID);
+				m_ComponentMasks.push_back(MUtility::EMPTY_BITSET);
+				m_ComponentIndices.push_back(std::vector<uint32_t>());
+			} break;
+
+			case DeferredCommandType::DestroyEntity:
+			{
+				if (m_EntityIDBank.IsIDActive(command.ID)) // The entity may have been destroyed multiple times during the concurrent phase
+					DestroyEntity(command.ID);
+			} break;
+
+			case DeferredCommandType::AddComponents:
+			{
+				if (m_EntityIDBank.IsIDActive(command.ID))
+					AddComponentsToEntity(command.ID, command.Mask);
+			} break;
+
+			case DeferredCommandType::RemoveComponents:
+			{
+				if (m_EntityIDBank.IsIDActive(command.ID))
+					RemoveComponentsFromEntity(command.ID, command.Mask);
+			} break;
+
+		default:
+			MLOG_ERROR("Received unknown deferred command type", LOG_CATEGORY_WORLD);
+			break;
+		}
+	}
+}
+
+
+int32_t World::GetEntityIndex(EntityID ID) const // TODODB: This function does not scale well; need to get rid of it or redesign
+{
+	for (int i = 0; i < m_Entities.size(); ++i)
+	{
+		if (m_Entities[i] == ID)
+		{
+			return i;
+		}
+	}
+
+	if (!m_IsInConcurrentAccess) // IDs reserved during concurrent access are active before their entities are created
+		MLOG_ERROR("Failed to find entity with ID " << ID << " even though it is marked as active", LOG_CATEGORY_WORLD);
+
+	return -1;
+}
+
+uint32_t World::CalcComponentIndiceListIndex(ComponentMask entityComponentMask, uint32_t componentBufferIndex) const
+{
+	uint64_t shiftedMask = componentBufferIndex != 0 ? (entityComponentMask << (MEngineComponentManager::MAX_COMPONENTS - componentBufferIndex)) : 0; // Shift away all bits above the component type bit index
+	return static_cast<uint32_t>(MUtility::PopCount(shiftedMask)); // Return the number of set bits left in the shifted mask
+}
+
+ComponentMask World::RemoveComponentsFromEntityByIndex(ComponentMask componentMask, int32_t entityIndex)
+{
+	ComponentMask failedComponents = 0ULL;
+	std::vector<uint32_t>& componentIndices = m_ComponentIndices[entityIndex];
+	while (componentMask != MUtility::EMPTY_BITSET)
+	{
+		ComponentMask singleComponentMask = MUtility::GetHighestSetBit(componentMask);
+		uint32_t bufferIndex = MUtilityMath::FastLog2(singleComponentMask);
+		uint32_t componentIndiceListIndex = CalcComponentIndiceListIndex(m_ComponentMasks[entityIndex], bufferIndex);
+		if (m_Buffers[bufferIndex]->ReturnComponent(componentIndices[componentIndiceListIndex]))
+		{
+			componentIndices.erase(componentIndices.begin() + componentIndiceListIndex);
+			m_ComponentMasks[entityIndex] &= ~MUtility::GetHighestSetBit(componentMask);
+		}
+		else
+			failedComponents |= MUtility::GetHighestSetBit(componentMask);
+
+		componentMask &= ~MUtility::GetHighestSetBit(componentMask);
+	}
+
+	return failedComponents;
+}
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+World::AccessGuard::AccessGuard(const World& world, bool isStructuralWrite) :
+	m_World(world), m_IsStructuralWrite(isStructuralWrite)
+{
+	if (m_IsStructuralWrite)
+	{
+		if (m_World.m_StructuralWriterCount++ > 0 || m_World.m_ReaderCount > 0)
+			MLOG_ERROR("Illegal structural change to a world that is being accessed by another thread; use BeginConcurrentAccess to defer structural changes", LOG_CATEGORY_WORLD);
+	}
+	else
+	{
+		++m_World.m_ReaderCount;
+		if (m_World.m_StructuralWriterCount > 0)
+			MLOG_ERROR("Illegal read from a world that is being structurally changed by another thread", LOG_CATEGORY_WORLD);
+	}
+}
+
+World::AccessGuard::~AccessGuard()
+{
+	if (m_IsStructuralWrite)
+		--m_World.m_StructuralWriterCount;
+	else
+		--m_World.m_ReaderCount;
+}
+#endif
\ No newline at end of file
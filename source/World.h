@@ -0,0 +1,123 @@
+#pragma once
+#include "Interface/MEngineEntityManager.h"
+#include "Interface/MEngineTypes.h"
+#include "ComponentBuffer.h"
+#include <MUtilityIDBank.h>
+#include <MUtilityPlatformDefinitions.h>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace MEngine
+{
+	enum class ComponentEventType
+	{
+		Added,
+		Removed,
+		Changed,
+	};
+
+	struct ComponentEvent
+	{
+		EntityID			ID;
+		ComponentMask		ComponentTypes;
+		ComponentEventType	Type;
+	};
+
+	class World // Owns all entity and component state for one isolated ECS world
+	{
+	public:
+		World();
+		World(const World& other) = delete;
+		~World();
+
+		World& operator=(const World& other) = delete;
+
+		EntityID CreateEntity();
+		bool DestroyEntity(EntityID ID);
+
+		ComponentMask AddComponentsToEntity(EntityID ID, ComponentMask componentMask);
+		ComponentMask RemoveComponentsFromEntity(EntityID ID, ComponentMask componentMask);
+
+		void GetEntitiesMatchingMask(ComponentMask componentMask, std::vector<EntityID>& outEntities, MaskMatchMode matchMode) const;
+
+		Component* GetComponent(EntityID ID, ComponentMask componentType) const;
+		Component* GetComponentByBufferIndex(EntityID ID, uint32_t componentBufferIndex) const; // The buffer index is the bit index of the component type mask
+		ComponentMask GetComponentMask(EntityID ID) const;
+
+		bool IsEntityIDValid(EntityID ID) const;
+
+		void UpdateComponentIndex(EntityID ID, ComponentMask componentType, uint32_t newComponentIndex);
+
+		void AddComponentBuffer(ComponentBuffer* buffer); // The world takes ownership of the buffer
+		bool RemoveComponentBuffer(ComponentMask componentType);
+		ComponentBuffer* GetComponentBuffer(ComponentMask componentType) const;
+
+		bool BeginConcurrentAccess();
+		bool EndConcurrentAccess(); // Applies all structural changes deferred during the concurrent phase
+		bool IsInConcurrentAccess() const;
+
+		void RecordComponentEvent(EntityID ID, ComponentMask componentTypes, ComponentEventType type); // Only observed component types are recorded
+		void TakeComponentEvents(std::vector<ComponentEvent>& outEvents);
+		void SetRecordsComponentEvents(bool recordsComponentEvents); // Clears all recorded events
+		uint64_t GetModificationCount() const; // Increased by every reported component change, observed or not
+
+	private:
+		enum class DeferredCommandType
+		{
+			CreateEntity,
+			DestroyEntity,
+			AddComponents,
+			RemoveComponents,
+		};
+
+		struct DeferredCommand
+		{
+			DeferredCommandType	Type;
+			EntityID			ID;
+			ComponentMask		Mask;
+		};
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+		class AccessGuard // Detects structural changes overlapping with other accesses to the world
+		{
+		public:
+			AccessGuard(const World& world, bool isStructuralWrite);
+			~AccessGuard();
+
+		private:
+			const World&	m_World;
+			const bool		m_IsStructuralWrite;
+		};
+#endif
+
+		void DeferCommand(DeferredCommandType type, EntityID ID, ComponentMask mask);
+		void ApplyDeferredCommands();
+
+		int32_t GetEntityIndex(EntityID ID) const;
+		uint32_t CalcComponentIndiceListIndex(ComponentMask entityComponentMask, uint32_t componentBufferIndex) const;
+		ComponentMask RemoveComponentsFromEntityByIndex(ComponentMask componentMask, int32_t entityIndex);
+
+		std::vector<EntityID>				m_Entities;
+		std::vector<ComponentMask>			m_ComponentMasks;
+		std::vector<std::vector<uint32_t>>	m_ComponentIndices;
+		MUtility::MUtilityIDBank<EntityID>	m_EntityIDBank;
+
+		std::vector<ComponentBuffer*>		m_Buffers; // Indexed by the bit index of the component type mask
+
+		std::atomic<bool>				m_IsInConcurrentAccess = false;
+		std::vector<DeferredCommand>	m_DeferredCommands;
+		std::mutex						m_DeferredCommandsLock;
+
+		std::atomic<bool>				m_RecordsComponentEvents = false;
+		std::vector<ComponentEvent>		m_ComponentEvents;
+		std::mutex						m_ComponentEventsLock;
+		std::atomic<uint64_t>			m_ModificationCount = 0;
+
+#if COMPILE_MODE == COMPILE_MODE_DEBUG
+		mutable std::atomic<int32_t> m_StructuralWriterCount	= 0;
+		mutable std::atomic<int32_t> m_ReaderCount				= 0;
+#endif
+	};
+}
\ No newline at end of file